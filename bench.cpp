@@ -0,0 +1,338 @@
+#include "bigint.hpp"
+#include "bigdecimal.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+
+/**
+ *
+ * @brief Builds a string of `length` random decimal digits with a non-zero leading digit.
+ *        A fixed seed keeps the operands identical between runs, so results from different commits are comparable.
+ *
+ * @param length The number of digits in the string.
+ * @param seed The seed of the random generator.
+ *
+ * @return The generated string of digits.
+ *
+ */
+static std::string random_digits(int64_t length, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> leading_digit(1, 9);
+    std::string digits(static_cast<size_t>(length), '0');
+    digits[0] = static_cast<char>('0' + leading_digit(generator));
+    for (size_t i = 1; i < digits.size(); ++i)
+    {
+        digits[i] = static_cast<char>('0' + digit(generator));
+    }
+    return digits;
+}
+
+static void BM_ConstructFromString(benchmark::State &state)
+{
+    std::string digits = random_digits(state.range(0), 1);
+    for (auto _ : state)
+    {
+        bigint num(digits);
+        benchmark::DoNotOptimize(num);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_ConstructFromInt64(benchmark::State &state)
+{
+    int64_t input_num = -4611686018427387904;
+    for (auto _ : state)
+    {
+        bigint num(input_num);
+        benchmark::DoNotOptimize(num);
+    }
+}
+
+static void BM_Output(benchmark::State &state)
+{
+    bigint num(random_digits(state.range(0), 2));
+    for (auto _ : state)
+    {
+        std::ostringstream os;
+        os << num;
+        benchmark::DoNotOptimize(os);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_Add(benchmark::State &state)
+{
+    bigint lhs(random_digits(state.range(0), 3));
+    bigint rhs(random_digits(state.range(0), 4));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs + rhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_Subtract(benchmark::State &state)
+{
+    bigint lhs(random_digits(state.range(0), 5));
+    bigint rhs(random_digits(state.range(0), 6));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs - rhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_Multiply(benchmark::State &state)
+{
+    bigint lhs(random_digits(state.range(0), 7));
+    bigint rhs(random_digits(state.range(0), 8));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs * rhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_Equal(benchmark::State &state)
+{
+    std::string digits = random_digits(state.range(0), 9);
+    bigint lhs(digits);
+    bigint rhs(digits);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_Less(benchmark::State &state)
+{
+    std::string digits = random_digits(state.range(0), 10);
+    bigint lhs(digits);
+    digits.back() = (digits.back() == '9') ? '8' : '9';
+    bigint rhs(digits);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs < rhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_PlusEquals(benchmark::State &state)
+{
+    bigint lhs(random_digits(state.range(0), 11));
+    bigint rhs(random_digits(state.range(0), 12));
+    for (auto _ : state)
+    {
+        lhs += rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_MinusEquals(benchmark::State &state)
+{
+    bigint lhs(random_digits(state.range(0), 13));
+    bigint rhs(random_digits(state.range(0), 14));
+    for (auto _ : state)
+    {
+        lhs -= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_MultiplyEquals(benchmark::State &state)
+{
+    bigint rhs(random_digits(state.range(0), 15));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        bigint lhs(random_digits(state.range(0), 16));
+        state.ResumeTiming();
+        lhs *= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_Increment(benchmark::State &state)
+{
+    bigint num(random_digits(state.range(0), 17));
+    for (auto _ : state)
+    {
+        ++num;
+        benchmark::DoNotOptimize(num);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_IsPerfectPower(benchmark::State &state)
+{
+    // Random digits are almost never a perfect power, so every exponent has to be ruled out.
+    bigint num(random_digits(state.range(0), 20));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(is_perfect_power(num));
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+/**
+ *
+ * @brief Builds a random odd modulus of `length` digits that does not end in 5, as `bigint_montgomery` requires.
+ *
+ * @param length The number of digits of the modulus.
+ * @param seed The seed of the random generator.
+ *
+ * @return The modulus.
+ *
+ */
+static bigint random_modulus(int64_t length, uint32_t seed)
+{
+    std::string digits = random_digits(length, seed);
+    digits.back() = "1379"[digits.back() % 4];
+    return bigint(digits);
+}
+
+static void BM_MontgomeryMultiply(benchmark::State &state)
+{
+    bigint_montgomery context(random_modulus(state.range(0), 21));
+    bigint lhs = context.to_montgomery(bigint(random_digits(state.range(0), 22)));
+    bigint rhs = context.to_montgomery(bigint(random_digits(state.range(0), 23)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(context.multiply(lhs, rhs));
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+// The baseline for BM_MontgomeryMultiply: a full product followed by the generic long division.
+// bigint has no public remainder, so the division runs through bigdecimal, which calls the same kernel.
+static void BM_DivisionModMultiply(benchmark::State &state)
+{
+    bigint modulus_num = random_modulus(state.range(0), 21);
+    bigdecimal modulus(modulus_num);
+    bigint lhs(random_digits(state.range(0), 22));
+    bigint rhs(random_digits(state.range(0), 23));
+    for (auto _ : state)
+    {
+        bigint product = lhs * rhs;
+        bigdecimal quotient = bigdecimal(product).divide(modulus, 0, BIGDECIMAL_ROUND_FLOOR);
+        benchmark::DoNotOptimize(product - quotient.unscaled() * modulus_num);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_IsProbablePrimeMersenne607(benchmark::State &state)
+{
+    bigint mersenne(int64_t(1));
+    for (int i = 0; i < 607; ++i)
+    {
+        mersenne *= bigint(int64_t(2));
+    }
+    --mersenne;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(is_probable_prime(mersenne, 1));
+    }
+}
+
+static void BM_Hash(benchmark::State &state)
+{
+    bigint num(random_digits(state.range(0), 18));
+    bigint_view view(num);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(view.hash());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_ToDouble(benchmark::State &state)
+{
+    bigint num(random_digits(state.range(0), 19));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(num.to_double());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+// The baseline for BM_ToDouble: printing the digits and parsing them back with strtod.
+static void BM_ToDoubleViaString(benchmark::State &state)
+{
+    bigint num(random_digits(state.range(0), 19));
+    for (auto _ : state)
+    {
+        std::ostringstream os;
+        os << num;
+        benchmark::DoNotOptimize(std::strtod(os.str().c_str(), nullptr));
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void BM_ToInt64(benchmark::State &state)
+{
+    bigint num(int64_t(-4611686018427387904));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(num.to_int64());
+    }
+}
+
+static void BM_ConstructFromDouble(benchmark::State &state)
+{
+    double input_num = -1.2345678901234567e300;
+    for (auto _ : state)
+    {
+        bigint num(input_num);
+        benchmark::DoNotOptimize(num);
+    }
+}
+
+// The baseline for BM_ConstructFromDouble: printing the double with snprintf and parsing the digits.
+static void BM_ConstructFromDoubleViaString(benchmark::State &state)
+{
+    double input_num = -1.2345678901234567e300;
+    char buffer[512];
+    for (auto _ : state)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%.0f", input_num);
+        bigint num{std::string(buffer)};
+        benchmark::DoNotOptimize(num);
+    }
+}
+
+// Linear-time operations are measured up to 10^7 digits.
+// The schoolbook multiplication is quadratic, so it stops at 10^4 digits to keep a run under a few minutes.
+BENCHMARK(BM_ConstructFromString)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_ConstructFromInt64);
+BENCHMARK(BM_Output)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_Add)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_Subtract)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_Multiply)->RangeMultiplier(10)->Range(1, 10000)->Complexity();
+BENCHMARK(BM_Equal)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_Less)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_PlusEquals)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_MinusEquals)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_MultiplyEquals)->RangeMultiplier(10)->Range(1, 10000)->Complexity();
+BENCHMARK(BM_Increment)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+BENCHMARK(BM_IsPerfectPower)->Arg(150)->Arg(300)->Arg(600)->Arg(1000);
+BENCHMARK(BM_MontgomeryMultiply)->Arg(100)->Arg(300)->Arg(600)->Complexity();
+BENCHMARK(BM_DivisionModMultiply)->Arg(100)->Arg(300)->Arg(600)->Complexity();
+BENCHMARK(BM_IsProbablePrimeMersenne607)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Hash)->RangeMultiplier(10)->Range(1, 10000000)->Complexity();
+// 20 to 309 digits is where to_double has to round, so that range gets extra sizes next to the string round-trip.
+BENCHMARK(BM_ToDouble)->RangeMultiplier(10)->Range(1, 10000000)->Arg(25)->Arg(150)->Arg(300);
+BENCHMARK(BM_ToDoubleViaString)->Arg(25)->Arg(100)->Arg(150)->Arg(300);
+BENCHMARK(BM_ToInt64);
+BENCHMARK(BM_ConstructFromDouble);
+BENCHMARK(BM_ConstructFromDoubleViaString);
+
+BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,518 @@
+#ifndef BIGDECIMAL_HPP
+#define BIGDECIMAL_HPP
+
+#include "bigint.hpp"
+
+/**
+ *
+ * @brief `bigdecimal_rounding` lists the rounding modes used when a `bigdecimal` loses digits.
+ *
+ *        BIGDECIMAL_ROUND_DOWN rounds toward zero, BIGDECIMAL_ROUND_UP rounds away from zero,
+ *        BIGDECIMAL_ROUND_FLOOR rounds toward negative infinity, BIGDECIMAL_ROUND_CEILING rounds toward positive infinity.
+ *        The three half modes round to the nearest value and differ only on an exact tie:
+ *        BIGDECIMAL_ROUND_HALF_UP goes away from zero, BIGDECIMAL_ROUND_HALF_DOWN goes toward zero,
+ *        and BIGDECIMAL_ROUND_HALF_EVEN goes to the neighbour with an even last digit (banker's rounding).
+ *
+ */
+enum bigdecimal_rounding
+{
+    BIGDECIMAL_ROUND_DOWN,
+    BIGDECIMAL_ROUND_UP,
+    BIGDECIMAL_ROUND_FLOOR,
+    BIGDECIMAL_ROUND_CEILING,
+    BIGDECIMAL_ROUND_HALF_UP,
+    BIGDECIMAL_ROUND_HALF_DOWN,
+    BIGDECIMAL_ROUND_HALF_EVEN
+};
+
+/**
+ *
+ * @class bigdecimal
+ *
+ * @brief The bigdecimal class is an exact decimal fixed-point number built on `bigint`.
+ *        A `bigdecimal` is an unscaled `bigint` together with a scale, and its value is unscaled * 10^(-scale).
+ *        For example, 123.45 is stored as unscaled = 12345 and scale = 2.
+ *
+ *        Because `bigint::value` already stores decimal digits, changing the scale only appends or drops digits,
+ *        and printing only places a decimal point between them. Both are linear and need no radix conversion.
+ *
+ */
+class bigdecimal
+{
+public:
+    bigdecimal();
+    bigdecimal(const bigint &input_unscaled, int64_t input_scale = 0);
+    bigdecimal(const std::string &input_digits);
+    const bigint &unscaled() const;
+    int64_t scale() const;
+    bigdecimal rescale(int64_t new_scale, bigdecimal_rounding mode = BIGDECIMAL_ROUND_HALF_EVEN) const;
+    bigdecimal divide(const bigdecimal &rhs, int64_t result_scale, bigdecimal_rounding mode = BIGDECIMAL_ROUND_HALF_EVEN) const;
+    bigdecimal operator+(const bigdecimal &rhs) const;
+    bigdecimal &operator+=(const bigdecimal &rhs);
+    bigdecimal operator-(const bigdecimal &rhs) const;
+    bigdecimal &operator-=(const bigdecimal &rhs);
+    bigdecimal operator*(const bigdecimal &rhs) const;
+    bigdecimal &operator*=(const bigdecimal &rhs);
+    bigdecimal operator-() const;
+    bool operator==(const bigdecimal &rhs) const;
+    bool operator!=(const bigdecimal &rhs) const;
+    bool operator<(const bigdecimal &rhs) const;
+    bool operator>(const bigdecimal &rhs) const;
+    bool operator<=(const bigdecimal &rhs) const;
+    bool operator>=(const bigdecimal &rhs) const;
+    friend std::ostream &operator<<(std::ostream &os, const bigdecimal &rhs);
+
+private:
+    static bigint round_quotient(const bigint &quotient, const bigint &remainder, const bigint &divisor, bigdecimal_rounding mode);
+    bigint aligned(int64_t target_scale) const;
+
+    /**
+     *
+     * @brief `unscaled_value` is the integer holding every digit of the number, without the decimal point.
+     *
+     */
+    bigint unscaled_value;
+
+    /**
+     *
+     * @brief `scale_digits` is the number of digits after the decimal point. It is never negative.
+     *
+     */
+    int64_t scale_digits;
+};
+
+/**
+ *
+ * @brief A default constructor, creating the decimal 0 with scale 0.
+ *
+ */
+bigdecimal::bigdecimal()
+{
+    scale_digits = 0;
+}
+
+/**
+ *
+ * @brief A constructor that takes an unscaled `bigint` and a scale, creating unscaled * 10^(-scale).
+ *
+ * @param input_unscaled The digits of the number, without the decimal point.
+ * @param input_scale The number of digits after the decimal point.
+ *
+ * @throws std::invalid_argument If the scale is negative.
+ *
+ */
+bigdecimal::bigdecimal(const bigint &input_unscaled, int64_t input_scale)
+{
+    if (input_scale < 0)
+    {
+        throw std::invalid_argument("The scale of a bigdecimal cannot be negative.");
+    }
+    unscaled_value = input_unscaled;
+    scale_digits = input_scale;
+}
+
+/**
+ *
+ * @brief A constructor that takes a decimal string such as "-123.4500" and converts it to a `bigdecimal`.
+ *        The scale is the number of digits after the decimal point, so trailing zeros are kept: "-123.4500" has scale 4.
+ *
+ * @param input_digits A string of digits with an optional sign and an optional decimal point followed by digits.
+ *
+ * @throws std::invalid_argument If the string is empty, has no digits, or contains illegal characters.
+ *
+ */
+bigdecimal::bigdecimal(const std::string &input_digits)
+{
+    size_t point = input_digits.find('.');
+    std::string integer_part = input_digits.substr(0, point);
+    std::string fraction_part = (point == std::string::npos) ? "" : input_digits.substr(point + 1);
+    size_t sign_length = (!integer_part.empty() && (integer_part[0] == '-' || integer_part[0] == '+')) ? 1 : 0;
+    if (integer_part.size() == sign_length || (point != std::string::npos && fraction_part.empty()))
+    {
+        throw std::invalid_argument("Please input a decimal number such as -123.45.");
+    }
+    for (char c : fraction_part)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(c)))
+        {
+            throw std::invalid_argument("Please make sure there are no illegal characters in your string.");
+        }
+    }
+    unscaled_value = bigint(integer_part + fraction_part);
+    scale_digits = static_cast<int64_t>(fraction_part.size());
+}
+
+/**
+ *
+ * @brief Returns the unscaled `bigint`, i.e. every digit of the number without the decimal point.
+ *
+ */
+const bigint &bigdecimal::unscaled() const
+{
+    return unscaled_value;
+}
+
+/**
+ *
+ * @brief Returns the number of digits after the decimal point.
+ *
+ */
+int64_t bigdecimal::scale() const
+{
+    return scale_digits;
+}
+
+/**
+ *
+ * @brief Rounds the truncated quotient of an exact division according to a rounding mode.
+ *        The remainder has the sign of the dividend, as returned by the `bigint` division.
+ *
+ * @param quotient The quotient truncated toward zero.
+ * @param remainder The remainder of the division.
+ * @param divisor The divisor of the division.
+ * @param mode The rounding mode.
+ *
+ * @return A new `bigint` representing the rounded quotient.
+ *
+ */
+bigint bigdecimal::round_quotient(const bigint &quotient, const bigint &remainder, const bigint &divisor, bigdecimal_rounding mode)
+{
+    if (remainder.is_zero())
+    {
+        return quotient;
+    }
+    bool is_negative = remainder.is_negative != divisor.is_negative;
+    bigint twice_remainder = remainder + remainder;
+    int half = bigint::compare_magnitude(twice_remainder.value, divisor.value);
+    bool is_away = false;
+    switch (mode)
+    {
+    case BIGDECIMAL_ROUND_DOWN:
+        is_away = false;
+        break;
+    case BIGDECIMAL_ROUND_UP:
+        is_away = true;
+        break;
+    case BIGDECIMAL_ROUND_FLOOR:
+        is_away = is_negative;
+        break;
+    case BIGDECIMAL_ROUND_CEILING:
+        is_away = !is_negative;
+        break;
+    case BIGDECIMAL_ROUND_HALF_UP:
+        is_away = half >= 0;
+        break;
+    case BIGDECIMAL_ROUND_HALF_DOWN:
+        is_away = half > 0;
+        break;
+    case BIGDECIMAL_ROUND_HALF_EVEN:
+        is_away = half > 0 || (half == 0 && quotient.value[0] % 2 == 1);
+        break;
+    }
+    if (!is_away)
+    {
+        return quotient;
+    }
+    return is_negative ? quotient - bigint(int64_t(1)) : quotient + bigint(int64_t(1));
+}
+
+/**
+ *
+ * @brief Returns the unscaled value this number would have at a larger or equal scale.
+ *
+ * @param target_scale The scale being aligned to, not smaller than the current scale.
+ *
+ * @return A new `bigint` representing the unscaled value at `target_scale`.
+ *
+ */
+bigint bigdecimal::aligned(int64_t target_scale) const
+{
+    return unscaled_value.shift_digits(target_scale - scale_digits);
+}
+
+/**
+ *
+ * @brief Changes the number of digits after the decimal point.
+ *        A larger scale appends zeros and is always exact. A smaller scale drops digits and rounds with `mode`.
+ *        Both only move digits, so the cost is linear in the number of digits.
+ *
+ * @param new_scale The new number of digits after the decimal point.
+ * @param mode The rounding mode used when digits are dropped.
+ *
+ * @return A new `bigdecimal` with scale `new_scale`.
+ *
+ * @throws std::invalid_argument If the new scale is negative.
+ *
+ */
+bigdecimal bigdecimal::rescale(int64_t new_scale, bigdecimal_rounding mode) const
+{
+    if (new_scale < 0)
+    {
+        throw std::invalid_argument("The scale of a bigdecimal cannot be negative.");
+    }
+    if (new_scale >= scale_digits)
+    {
+        return bigdecimal(aligned(new_scale), new_scale);
+    }
+    int64_t dropped = scale_digits - new_scale;
+    bigint quotient = unscaled_value.shift_digits(-dropped);
+    bigint remainder = unscaled_value - quotient.shift_digits(dropped);
+    bigint divisor = bigint(int64_t(1)).shift_digits(dropped);
+    return bigdecimal(round_quotient(quotient, remainder, divisor, mode), new_scale);
+}
+
+/**
+ *
+ * @brief Divides two `bigdecimal` objects, rounding the quotient to a given scale.
+ *        The dividend is shifted so that one integer division yields the quotient at `result_scale`, and the
+ *        remainder decides the rounding, so the result is the exact quotient correctly rounded with `mode`.
+ *
+ * @param rhs The divisor.
+ * @param result_scale The number of digits after the decimal point in the quotient.
+ * @param mode The rounding mode.
+ *
+ * @return A new `bigdecimal` representing the rounded quotient.
+ *
+ * @throws std::invalid_argument If the divisor is 0 or the scale is negative.
+ *
+ */
+bigdecimal bigdecimal::divide(const bigdecimal &rhs, int64_t result_scale, bigdecimal_rounding mode) const
+{
+    if (result_scale < 0)
+    {
+        throw std::invalid_argument("The scale of a bigdecimal cannot be negative.");
+    }
+    int64_t exponent = result_scale - scale_digits + rhs.scale_digits;
+    bigint dividend = (exponent >= 0) ? unscaled_value.shift_digits(exponent) : unscaled_value;
+    bigint divisor = (exponent >= 0) ? rhs.unscaled_value : rhs.unscaled_value.shift_digits(-exponent);
+    bigint quotient;
+    bigint remainder;
+    bigint::divide(dividend, divisor, quotient, remainder);
+    return bigdecimal(round_quotient(quotient, remainder, divisor, mode), result_scale);
+}
+
+/**
+ *
+ * @brief This method implements the addition operation of two bigdecimal objects.
+ *        The result has the larger of the two scales, so the addition is exact.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return A new `bigdecimal` representing the result of adding.
+ *
+ */
+bigdecimal bigdecimal::operator+(const bigdecimal &rhs) const
+{
+    int64_t result_scale = std::max(scale_digits, rhs.scale_digits);
+    return bigdecimal(aligned(result_scale) + rhs.aligned(result_scale), result_scale);
+}
+
+/**
+ *
+ * @brief This method implements the += operator for the bigdecimal class.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return The left-hand side `bigdecimal` object's reference after the addition.
+ *
+ */
+bigdecimal &bigdecimal::operator+=(const bigdecimal &rhs)
+{
+    *this = *this + rhs;
+    return *this;
+}
+
+/**
+ *
+ * @brief This method implements the subtraction operation of two bigdecimal objects.
+ *        The result has the larger of the two scales, so the subtraction is exact.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return A new `bigdecimal` representing the result of subtracting.
+ *
+ */
+bigdecimal bigdecimal::operator-(const bigdecimal &rhs) const
+{
+    int64_t result_scale = std::max(scale_digits, rhs.scale_digits);
+    return bigdecimal(aligned(result_scale) - rhs.aligned(result_scale), result_scale);
+}
+
+/**
+ *
+ * @brief This method implements the -= operator for the bigdecimal class.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return The left-hand side `bigdecimal` object's reference after the subtraction.
+ *
+ */
+bigdecimal &bigdecimal::operator-=(const bigdecimal &rhs)
+{
+    *this = *this - rhs;
+    return *this;
+}
+
+/**
+ *
+ * @brief This method implements the multiplication operation of two bigdecimal objects.
+ *        The result has the sum of the two scales, so the multiplication is exact.
+ *        Use `rescale` to bring it back to a fixed number of digits.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return A new `bigdecimal` representing the result of multiplication.
+ *
+ */
+bigdecimal bigdecimal::operator*(const bigdecimal &rhs) const
+{
+    return bigdecimal(unscaled_value * rhs.unscaled_value, scale_digits + rhs.scale_digits);
+}
+
+/**
+ *
+ * @brief This method implements the *= operator for the bigdecimal class.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return The left-hand side `bigdecimal` object's reference after the multiplication.
+ *
+ */
+bigdecimal &bigdecimal::operator*=(const bigdecimal &rhs)
+{
+    *this = *this * rhs;
+    return *this;
+}
+
+/**
+ *
+ * @brief This method implements the unary minus operator for the bigdecimal class.
+ *
+ * @return A new `bigdecimal` with the opposite sign and the same scale.
+ *
+ */
+bigdecimal bigdecimal::operator-() const
+{
+    return bigdecimal(-unscaled_value, scale_digits);
+}
+
+/**
+ *
+ * @brief Compares two `bigdecimal` objects for numeric equality, regardless of their scales, e.g. 1.5 == 1.50.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return `true` if both numbers have the same value, otherwise `false`.
+ *
+ */
+bool bigdecimal::operator==(const bigdecimal &rhs) const
+{
+    int64_t common_scale = std::max(scale_digits, rhs.scale_digits);
+    return aligned(common_scale) == rhs.aligned(common_scale);
+}
+
+/**
+ *
+ * @brief Compares two `bigdecimal` objects for numeric inequality.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return `false` if both numbers have the same value, otherwise `true`.
+ *
+ */
+bool bigdecimal::operator!=(const bigdecimal &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ *
+ * @brief Checks whether one `bigdecimal` is numerically smaller than another.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return `true` if the left-hand side number is smaller, otherwise `false`.
+ *
+ */
+bool bigdecimal::operator<(const bigdecimal &rhs) const
+{
+    int64_t common_scale = std::max(scale_digits, rhs.scale_digits);
+    return aligned(common_scale) < rhs.aligned(common_scale);
+}
+
+/**
+ *
+ * @brief Checks whether one `bigdecimal` is numerically greater than another.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return `true` if the left-hand side number is greater, otherwise `false`.
+ *
+ */
+bool bigdecimal::operator>(const bigdecimal &rhs) const
+{
+    return rhs < *this;
+}
+
+/**
+ *
+ * @brief Checks whether one `bigdecimal` is numerically smaller than or equal to another.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return `true` if the left-hand side number is smaller or equal, otherwise `false`.
+ *
+ */
+bool bigdecimal::operator<=(const bigdecimal &rhs) const
+{
+    return !(rhs < *this);
+}
+
+/**
+ *
+ * @brief Checks whether one `bigdecimal` is numerically greater than or equal to another.
+ *
+ * @param rhs The right-hand side `bigdecimal` object.
+ *
+ * @return `true` if the left-hand side number is greater or equal, otherwise `false`.
+ *
+ */
+bool bigdecimal::operator>=(const bigdecimal &rhs) const
+{
+    return !(*this < rhs);
+}
+
+/**
+ *
+ * @brief The output stream insertion operator << prints the bigdecimal with exactly `scale` digits after the point.
+ *        The digits of the unscaled `bigint` are written directly, with leading zeros added when the number is below 1.
+ *
+ * @param os The output stream.
+ * @param rhs The right-hand side `bigdecimal` object which should be output.
+ *
+ * @return A reference to the output stream.
+ *
+ */
+std::ostream &operator<<(std::ostream &os, const bigdecimal &rhs)
+{
+    const std::vector<int64_t> &digits = rhs.unscaled_value.value;
+    size_t scale = static_cast<size_t>(rhs.scale_digits);
+    size_t length = std::max(digits.size(), scale + 1);
+    std::string text;
+    text.reserve(length + 2);
+    if (rhs.unscaled_value.is_negative)
+    {
+        text.push_back('-');
+    }
+    for (size_t i = length; i > 0; --i)
+    {
+        if (i == scale)
+        {
+            text.push_back('.');
+        }
+        text.push_back(static_cast<char>(((i - 1 < digits.size()) ? digits[i - 1] : 0) + '0'));
+    }
+    return os << text;
+}
+
+#endif
\ No newline at end of file
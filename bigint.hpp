@@ -1,8 +1,233 @@
+#ifndef BIGINT_HPP
+#define BIGINT_HPP
+
 #include <iostream>
 #include <cstdint>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <stdexcept>
+#include <atomic>
+#include <future>
+#include <random>
+#include <thread>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef BIGINT_INSTRUMENTATION
+#include <chrono>
+
+/**
+ *
+ * @brief `bigint_op` lists the operations tracked by the opt-in instrumentation layer.
+ *        Multiplication is tracked per algorithm tier; schoolbook is the only tier at the moment.
+ *
+ */
+enum bigint_op
+{
+    BIGINT_OP_CONSTRUCT,
+    BIGINT_OP_ADD,
+    BIGINT_OP_SUBTRACT,
+    BIGINT_OP_MULTIPLY_SCHOOLBOOK,
+    BIGINT_OP_COMPARE,
+    BIGINT_OP_OUTPUT,
+    BIGINT_OP_DIVIDE,
+    BIGINT_OP_COUNT
+};
+
+/**
+ *
+ * @brief `bigint_op_stats` holds the counters of one operation.
+ *        `calls` is the number of calls, counted at entry; a nested call is counted separately under its own operation,
+ *        e.g. `5 + -3` counts one addition and one subtraction. `limbs` is the number of digits read from the operands,
+ *        `allocations` and `bytes` describe the result buffers allocated, and `nanoseconds` is the
+ *        inclusive wall time, only filled when `BIGINT_INSTRUMENTATION_TIMING` is also defined.
+ *
+ */
+struct bigint_op_stats
+{
+    uint64_t calls;
+    uint64_t limbs;
+    uint64_t allocations;
+    uint64_t bytes;
+    uint64_t nanoseconds;
+};
+
+/**
+ *
+ * @brief `bigint_stats` is a snapshot of the counters of every operation, indexed by `bigint_op`.
+ *
+ */
+struct bigint_stats
+{
+    bigint_op_stats ops[BIGINT_OP_COUNT];
+};
+
+/**
+ *
+ * @brief `bigint_op_counters` is the live, thread-safe counterpart of `bigint_op_stats`.
+ *
+ */
+struct bigint_op_counters
+{
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> limbs;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> nanoseconds;
+};
+
+/**
+ *
+ * @brief Returns the process-wide table of live counters, indexed by `bigint_op`.
+ *
+ */
+bigint_op_counters *bigint_counters()
+{
+    static bigint_op_counters counters[BIGINT_OP_COUNT];
+    return counters;
+}
+
+/**
+ *
+ * @brief Records one call of an operation and the number of digits it read.
+ *
+ * @param op The operation being recorded.
+ * @param limbs The number of digits read from the operands.
+ *
+ */
+void bigint_record_call(bigint_op op, uint64_t limbs)
+{
+    bigint_counters()[op].calls.fetch_add(1, std::memory_order_relaxed);
+    bigint_counters()[op].limbs.fetch_add(limbs, std::memory_order_relaxed);
+}
+
+/**
+ *
+ * @brief Records one result buffer allocated by an operation.
+ *
+ * @param op The operation being recorded.
+ * @param bytes The size of the buffer in bytes.
+ *
+ */
+void bigint_record_allocation(bigint_op op, uint64_t bytes)
+{
+    bigint_counters()[op].allocations.fetch_add(1, std::memory_order_relaxed);
+    bigint_counters()[op].bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ *
+ * @brief Takes a snapshot of every counter.
+ *        Each counter is read atomically, but counters updated concurrently may be read at slightly different moments.
+ *
+ * @return The snapshot of the counters.
+ *
+ */
+bigint_stats bigint_stats_snapshot()
+{
+    bigint_stats snapshot;
+    for (int op = 0; op < BIGINT_OP_COUNT; ++op)
+    {
+        snapshot.ops[op].calls = bigint_counters()[op].calls.load(std::memory_order_relaxed);
+        snapshot.ops[op].limbs = bigint_counters()[op].limbs.load(std::memory_order_relaxed);
+        snapshot.ops[op].allocations = bigint_counters()[op].allocations.load(std::memory_order_relaxed);
+        snapshot.ops[op].bytes = bigint_counters()[op].bytes.load(std::memory_order_relaxed);
+        snapshot.ops[op].nanoseconds = bigint_counters()[op].nanoseconds.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+/**
+ *
+ * @brief Sets every counter back to 0.
+ *
+ */
+void bigint_stats_reset()
+{
+    for (int op = 0; op < BIGINT_OP_COUNT; ++op)
+    {
+        bigint_counters()[op].calls.store(0, std::memory_order_relaxed);
+        bigint_counters()[op].limbs.store(0, std::memory_order_relaxed);
+        bigint_counters()[op].allocations.store(0, std::memory_order_relaxed);
+        bigint_counters()[op].bytes.store(0, std::memory_order_relaxed);
+        bigint_counters()[op].nanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ *
+ * @class bigint_timer
+ *
+ * @brief `bigint_timer` adds the time between its construction and destruction to the `nanoseconds` counter of an operation.
+ *        Operations that call other operations are timed inclusively, e.g. a mixed-sign addition also counts as a subtraction.
+ *
+ */
+class bigint_timer
+{
+public:
+    explicit bigint_timer(bigint_op op) : op(op), start(std::chrono::steady_clock::now()) {}
+    ~bigint_timer()
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        bigint_counters()[op].nanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+    }
+
+private:
+    bigint_op op;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define BIGINT_RECORD_CALL(op, limbs) bigint_record_call(op, limbs)
+#define BIGINT_RECORD_ALLOCATION(op, num) bigint_record_allocation(op, (num).value.capacity() * sizeof(int64_t))
+#ifdef BIGINT_INSTRUMENTATION_TIMING
+#define BIGINT_TIME(op) bigint_timer bigint_scope_timer(op)
+#else
+#define BIGINT_TIME(op)
+#endif
+
+#else
+#define BIGINT_RECORD_CALL(op, limbs)
+#define BIGINT_RECORD_ALLOCATION(op, num)
+#define BIGINT_TIME(op)
+#endif
+
+#ifdef BIGINT_CACHE_HASH
+/**
+ *
+ * @class bigint_hash_cache
+ *
+ * @brief `bigint_hash_cache` stores the hash of a `bigint` once it has been computed, 0 meaning not computed yet.
+ *        The value is a relaxed atomic, so threads may hash the same shared `bigint` concurrently.
+ *        Copying a `bigint` copies its cached hash together with its digits.
+ *
+ */
+class bigint_hash_cache
+{
+public:
+    bigint_hash_cache() : hash(0) {}
+    bigint_hash_cache(const bigint_hash_cache &rhs) : hash(rhs.hash.load(std::memory_order_relaxed)) {}
+    bigint_hash_cache &operator=(const bigint_hash_cache &rhs)
+    {
+        hash.store(rhs.hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+    mutable std::atomic<size_t> hash;
+};
+#define BIGINT_INVALIDATE_HASH(num) (num).hash_cache.hash.store(0, std::memory_order_relaxed)
+#else
+#define BIGINT_INVALIDATE_HASH(num)
+#endif
+
+class bigint_montgomery;
+class bigint_view;
+class bigdecimal;
 
 /**
  *
@@ -20,6 +245,11 @@ public:
     bigint();
     bigint(int64_t input_num);
     bigint(const std::string &input_digits);
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    explicit bigint(T input_num);
+    bool fits_int64() const;
+    int64_t to_int64() const;
+    double to_double() const;
     bigint operator+(const bigint &rhs) const;
     bigint &operator+=(const bigint &rhs);
     bigint operator-(const bigint &rhs) const;
@@ -38,8 +268,44 @@ public:
     bigint operator++(int);
     bigint &operator--();
     bigint operator--(int);
+    friend bigint isqrt(const bigint &n);
+    friend bigint iroot(const bigint &n, int64_t k);
+    friend bool is_perfect_square(const bigint &n);
+    friend bool is_perfect_power(const bigint &n);
+    friend bigint modinv(const bigint &a, const bigint &m);
+    friend bool is_probable_prime(const bigint &n, int rounds);
+    friend bigint binomial(int64_t n, int64_t k);
+    friend class bigint_montgomery;
+    friend class bigint_view;
+    friend class bigdecimal;
+    friend std::ostream &operator<<(std::ostream &os, const bigdecimal &rhs);
+    friend struct std::hash<bigint>;
 
 private:
+    bool is_zero() const;
+    bigint shift_digits(int64_t digits) const;
+    uint64_t magnitude_to_uint64() const;
+    static bigint from_uint64(uint64_t input_num);
+    static int compare_magnitude(const std::vector<int64_t> &lhs, const std::vector<int64_t> &rhs);
+    static void subtract_magnitude(std::vector<int64_t> &lhs, const std::vector<int64_t> &rhs, int64_t multiple);
+    static void divide(const bigint &dividend, const bigint &divisor, bigint &quotient, bigint &remainder);
+    static bigint power(const bigint &base, int64_t exponent);
+    static bool power_exceeds(uint64_t base, int64_t exponent, uint64_t limit);
+    static uint64_t small_root(uint64_t n, int64_t k);
+    static bigint root_magnitude(const bigint &n, int64_t k);
+    int64_t magnitude_mod(int64_t modulus) const;
+    static bool may_be_power(const bigint &n, int64_t k);
+    static bigint from_double(double input_num);
+    static bigint from_long_double(long double input_num);
+    static bigint from_binary(uint64_t mantissa, int64_t exponent);
+    bigint low_digits(size_t count) const;
+    static bigint divide_small(const bigint &dividend, int64_t divisor, int64_t &remainder);
+    static bigint mod_floor(const bigint &num, const bigint &modulus);
+    static const std::vector<int64_t> &small_primes();
+    static int jacobi(int64_t a, const bigint &n);
+    static bool is_strong_probable_prime(const bigint_montgomery &context, const bigint &base, const bigint &odd_part, int64_t twos);
+    static bool is_strong_lucas_probable_prime(const bigint &n, const bigint_montgomery &context);
+
     /**
      *
      * @brief `value` is a vector type of data used to store each digit of an arbitrary-precision integer.
@@ -60,6 +326,16 @@ private:
      *
      */
     bool is_negative;
+
+#ifdef BIGINT_CACHE_HASH
+    /**
+     *
+     * @brief `hash_cache` keeps the value of `std::hash<bigint>` after its first computation.
+     *        Only present when `BIGINT_CACHE_HASH` is defined.
+     *
+     */
+    bigint_hash_cache hash_cache;
+#endif
 };
 
 /**
@@ -74,12 +350,15 @@ bigint::bigint()
 {
     value = {0};
     is_negative = false;
+    BIGINT_RECORD_CALL(BIGINT_OP_CONSTRUCT, 0);
+    BIGINT_RECORD_ALLOCATION(BIGINT_OP_CONSTRUCT, *this);
 }
 
 /**
  *
  * @brief A constructor that takes a signed 64-bit integer and converts it to an arbitrary-precision integer.
  *        This constructor is used to initialize a bigint object with an int64_t type of data.
+ *        The digits are taken from the unsigned magnitude, so INT64_MIN is converted without overflow.
  *
  * @param input_num The signed 64-bit integer to initialize the `bigint` object.
  *
@@ -95,14 +374,17 @@ bigint::bigint(int64_t input_num)
         is_negative = false;
     }
 
+    uint64_t magnitude = static_cast<uint64_t>(input_num);
     if (is_negative == true)
-        input_num = -input_num;
+        magnitude = 0 - magnitude;
 
     do
     {
-        value.push_back(input_num % 10);
-        input_num = input_num / 10;
-    } while (input_num != 0);
+        value.push_back(static_cast<int64_t>(magnitude % 10));
+        magnitude = magnitude / 10;
+    } while (magnitude != 0);
+    BIGINT_RECORD_CALL(BIGINT_OP_CONSTRUCT, value.size());
+    BIGINT_RECORD_ALLOCATION(BIGINT_OP_CONSTRUCT, *this);
 }
 
 /**
@@ -117,6 +399,7 @@ bigint::bigint(int64_t input_num)
  */
 bigint::bigint(const std::string &input_digits)
 {
+    BIGINT_TIME(BIGINT_OP_CONSTRUCT);
     if (input_digits.empty())
     {
         throw std::invalid_argument("Please input a string of digits");
@@ -176,6 +459,12 @@ bigint::bigint(const std::string &input_digits)
     {
         value.pop_back();
     }
+    if (value.size() == 1 && value[0] == 0)
+    {
+        is_negative = false;
+    }
+    BIGINT_RECORD_CALL(BIGINT_OP_CONSTRUCT, input_digits.size());
+    BIGINT_RECORD_ALLOCATION(BIGINT_OP_CONSTRUCT, *this);
 }
 
 /**
@@ -189,12 +478,15 @@ bigint::bigint(const std::string &input_digits)
  */
 bigint bigint::operator+(const bigint &rhs) const
 {
+    BIGINT_TIME(BIGINT_OP_ADD);
+    BIGINT_RECORD_CALL(BIGINT_OP_ADD, value.size() + rhs.value.size());
     bigint sum;
     if (is_negative == rhs.is_negative)
     {
         sum.is_negative = is_negative;
         size_t max_length = std::max(value.size(), rhs.value.size());
         sum.value.resize(max_length);
+        BIGINT_RECORD_ALLOCATION(BIGINT_OP_ADD, sum);
         int64_t carry = 0;
         for (size_t i = 0; i < max_length; ++i)
         {
@@ -251,6 +543,8 @@ bigint &bigint::operator+=(const bigint &rhs)
  */
 bigint bigint::operator-(const bigint &rhs) const
 {
+    BIGINT_TIME(BIGINT_OP_SUBTRACT);
+    BIGINT_RECORD_CALL(BIGINT_OP_SUBTRACT, value.size() + rhs.value.size());
     bigint subtract;
     if (is_negative == rhs.is_negative)
     {
@@ -268,6 +562,7 @@ bigint bigint::operator-(const bigint &rhs) const
                 subtract.is_negative = (*this < rhs) ? !is_negative : is_negative;
                 size_t max_length = larger_num.value.size();
                 subtract.value.resize(max_length);
+                BIGINT_RECORD_ALLOCATION(BIGINT_OP_SUBTRACT, subtract);
                 int64_t borrow = 0;
                 for (size_t i = 0; i < max_length; ++i)
                 {
@@ -291,6 +586,7 @@ bigint bigint::operator-(const bigint &rhs) const
                 subtract.is_negative = (*this < rhs) ? is_negative : !is_negative;
                 size_t max_length = smaller_num.value.size();
                 subtract.value.resize(max_length);
+                BIGINT_RECORD_ALLOCATION(BIGINT_OP_SUBTRACT, subtract);
                 int64_t borrow = 0;
                 for (size_t i = 0; i < max_length; ++i)
                 {
@@ -350,9 +646,12 @@ bigint &bigint::operator-=(const bigint &rhs)
  */
 bigint bigint::operator*(const bigint &rhs) const
 {
+    BIGINT_TIME(BIGINT_OP_MULTIPLY_SCHOOLBOOK);
+    BIGINT_RECORD_CALL(BIGINT_OP_MULTIPLY_SCHOOLBOOK, value.size() + rhs.value.size());
     bigint product;
     product.is_negative = (is_negative == rhs.is_negative) ? false : true;
     product.value.resize(value.size() + rhs.value.size());
+    BIGINT_RECORD_ALLOCATION(BIGINT_OP_MULTIPLY_SCHOOLBOOK, product);
     for (size_t i = 0; i < value.size(); ++i)
     {
         int64_t carry = 0;
@@ -368,6 +667,10 @@ bigint bigint::operator*(const bigint &rhs) const
     {
         product.value.pop_back();
     }
+    if (product.value.size() == 1 && product.value[0] == 0)
+    {
+        product.is_negative = false;
+    }
 
     return product;
 }
@@ -420,6 +723,7 @@ bigint bigint::operator-() const
  */
 bool bigint::operator==(const bigint &rhs) const
 {
+    BIGINT_RECORD_CALL(BIGINT_OP_COMPARE, value.size() + rhs.value.size());
     if (is_negative != rhs.is_negative)
     {
         return false;
@@ -471,6 +775,7 @@ bool bigint::operator!=(const bigint &rhs) const
  */
 bool bigint::operator<(const bigint &rhs) const
 {
+    BIGINT_RECORD_CALL(BIGINT_OP_COMPARE, value.size() + rhs.value.size());
     if (is_negative != rhs.is_negative)
     {
         return is_negative;
@@ -575,6 +880,8 @@ bool bigint::operator>=(const bigint &rhs) const
  */
 std::ostream &operator<<(std::ostream &os, const bigint &rhs)
 {
+    BIGINT_TIME(BIGINT_OP_OUTPUT);
+    BIGINT_RECORD_CALL(BIGINT_OP_OUTPUT, rhs.value.size());
     if (rhs.is_negative)
     {
         os << '-';
@@ -644,4 +951,2310 @@ bigint bigint::operator--(int)
     bigint current_num = *this;
     --(*this);
     return current_num;
-}
\ No newline at end of file
+}
+
+/**
+ *
+ * @brief Checks whether the `bigint` object is 0.
+ *
+ * @return `true` if the value is 0, otherwise `false`.
+ *
+ */
+bool bigint::is_zero() const
+{
+    return value.size() == 1 && value[0] == 0;
+}
+
+/**
+ *
+ * @brief Multiplies or divides the `bigint` object by a power of ten by moving its digits.
+ *        Because `value` stores decimal digits, this is a linear copy and needs no multiplication.
+ *
+ * @param digits The power of ten. A positive number appends zeros at the lowest digits,
+ *               a negative number drops the lowest digits, which truncates toward zero.
+ *
+ * @return A new `bigint` representing the shifted value.
+ *
+ */
+bigint bigint::shift_digits(int64_t digits) const
+{
+    bigint shifted;
+    if (is_zero())
+    {
+        return shifted;
+    }
+    if (digits >= 0)
+    {
+        shifted.value.assign(static_cast<size_t>(digits), 0);
+        shifted.value.insert(shifted.value.end(), value.begin(), value.end());
+    }
+    else
+    {
+        size_t dropped = static_cast<size_t>(-digits);
+        if (dropped >= value.size())
+        {
+            return shifted;
+        }
+        shifted.value.assign(value.begin() + dropped, value.end());
+    }
+    shifted.is_negative = is_negative;
+    return shifted;
+}
+
+/**
+ *
+ * @brief Converts the magnitude of a `bigint` object with at most 19 digits to an unsigned 64-bit integer.
+ *
+ * @return The absolute value as `uint64_t`.
+ *
+ */
+uint64_t bigint::magnitude_to_uint64() const
+{
+    uint64_t magnitude = 0;
+    for (size_t i = value.size(); i > 0; --i)
+    {
+        magnitude = magnitude * 10 + static_cast<uint64_t>(value[i - 1]);
+    }
+    return magnitude;
+}
+
+/**
+ *
+ * @brief Converts an unsigned 64-bit integer to a non-negative `bigint` object.
+ *
+ * @param input_num The unsigned 64-bit integer.
+ *
+ * @return A new `bigint` holding `input_num`.
+ *
+ */
+bigint bigint::from_uint64(uint64_t input_num)
+{
+    bigint converted;
+    converted.value.clear();
+    do
+    {
+        converted.value.push_back(static_cast<int64_t>(input_num % 10));
+        input_num = input_num / 10;
+    } while (input_num != 0);
+    return converted;
+}
+
+/**
+ *
+ * @brief Compares two digit vectors without leading zeros as non-negative numbers.
+ *        An empty vector stands for 0.
+ *
+ * @param lhs The left-hand side digits.
+ * @param rhs The right-hand side digits.
+ *
+ * @return A negative number if `lhs` is smaller, 0 if they are equal, a positive number if `lhs` is greater.
+ *
+ */
+int bigint::compare_magnitude(const std::vector<int64_t> &lhs, const std::vector<int64_t> &rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return (lhs.size() < rhs.size()) ? -1 : 1;
+    }
+    for (size_t i = lhs.size(); i > 0; --i)
+    {
+        if (lhs[i - 1] != rhs[i - 1])
+        {
+            return (lhs[i - 1] < rhs[i - 1]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ *
+ * @brief Subtracts `multiple` times `rhs` from `lhs` in place, treating both as non-negative digit vectors.
+ *        The caller guarantees the result is not negative. Leading zeros are removed, so 0 becomes an empty vector.
+ *
+ * @param lhs The digits being reduced.
+ * @param rhs The digits being subtracted.
+ * @param multiple A single digit multiplier of `rhs`.
+ *
+ */
+void bigint::subtract_magnitude(std::vector<int64_t> &lhs, const std::vector<int64_t> &rhs, int64_t multiple)
+{
+    int64_t borrow = 0;
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        int64_t digit_r = (i < rhs.size()) ? rhs[i] * multiple : 0;
+        int64_t sub_digit = lhs[i] - digit_r - borrow;
+        borrow = 0;
+        if (sub_digit < 0)
+        {
+            borrow = (9 - sub_digit) / 10;
+            sub_digit += borrow * 10;
+        }
+        lhs[i] = sub_digit;
+    }
+    while (!lhs.empty() && lhs.back() == 0)
+    {
+        lhs.pop_back();
+    }
+}
+
+/**
+ *
+ * @brief Divides two `bigint` objects with the schoolbook long division, truncating toward zero.
+ *        Every quotient digit is first estimated from the leading 18 digits of the divisor, which never overshoots,
+ *        and is then corrected by at most a few extra subtractions.
+ *        The remainder has the sign of the dividend, matching the built-in integer division.
+ *
+ * @param dividend The `bigint` being divided.
+ * @param divisor The `bigint` dividing it.
+ * @param quotient Receives the quotient.
+ * @param remainder Receives the remainder.
+ *
+ * @throws std::invalid_argument If the divisor is 0.
+ *
+ */
+void bigint::divide(const bigint &dividend, const bigint &divisor, bigint &quotient, bigint &remainder)
+{
+    if (divisor.is_zero())
+    {
+        throw std::invalid_argument("Division by zero.");
+    }
+    BIGINT_TIME(BIGINT_OP_DIVIDE);
+    BIGINT_RECORD_CALL(BIGINT_OP_DIVIDE, dividend.value.size() + divisor.value.size());
+
+    const std::vector<int64_t> &digits_d = divisor.value;
+    size_t length_d = digits_d.size();
+    size_t leading_length = std::min<size_t>(length_d, 18);
+    uint64_t leading_d = 0;
+    for (size_t i = length_d; i > length_d - leading_length; --i)
+    {
+        leading_d = leading_d * 10 + static_cast<uint64_t>(digits_d[i - 1]);
+    }
+
+    std::vector<int64_t> digits_q(dividend.value.size(), 0);
+    std::vector<int64_t> digits_r;
+    for (size_t i = dividend.value.size(); i > 0; --i)
+    {
+        if (!digits_r.empty() || dividend.value[i - 1] != 0)
+        {
+            digits_r.insert(digits_r.begin(), dividend.value[i - 1]);
+        }
+        if (digits_r.size() < length_d)
+        {
+            continue;
+        }
+
+        // The remainder is below 10 times the divisor, so its leading part has at most 19 digits.
+        uint64_t leading_r = 0;
+        for (size_t j = digits_r.size(); j > length_d - leading_length; --j)
+        {
+            leading_r = leading_r * 10 + static_cast<uint64_t>(digits_r[j - 1]);
+        }
+        int64_t digit_q = static_cast<int64_t>(leading_r / (leading_d + 1));
+        if (digit_q > 0)
+        {
+            subtract_magnitude(digits_r, digits_d, digit_q);
+        }
+        while (compare_magnitude(digits_r, digits_d) >= 0)
+        {
+            subtract_magnitude(digits_r, digits_d, 1);
+            ++digit_q;
+        }
+        digits_q[i - 1] = digit_q;
+    }
+
+    while (digits_q.size() > 1 && digits_q.back() == 0)
+    {
+        digits_q.pop_back();
+    }
+    if (digits_r.empty())
+    {
+        digits_r.push_back(0);
+    }
+    BIGINT_INVALIDATE_HASH(quotient);
+    BIGINT_INVALIDATE_HASH(remainder);
+    quotient.value = std::move(digits_q);
+    quotient.is_negative = !quotient.is_zero() && (dividend.is_negative != divisor.is_negative);
+    remainder.value = std::move(digits_r);
+    remainder.is_negative = !remainder.is_zero() && dividend.is_negative;
+    BIGINT_RECORD_ALLOCATION(BIGINT_OP_DIVIDE, quotient);
+    BIGINT_RECORD_ALLOCATION(BIGINT_OP_DIVIDE, remainder);
+}
+
+/**
+ *
+ * @brief Raises a `bigint` object to a non-negative power by repeated squaring.
+ *
+ * @param base The base.
+ * @param exponent The non-negative exponent.
+ *
+ * @return A new `bigint` representing `base` to the power of `exponent`.
+ *
+ */
+bigint bigint::power(const bigint &base, int64_t exponent)
+{
+    bigint result(int64_t(1));
+    bigint square = base;
+    while (exponent > 0)
+    {
+        if (exponent % 2 == 1)
+        {
+            result *= square;
+        }
+        exponent /= 2;
+        if (exponent > 0)
+        {
+            square *= square;
+        }
+    }
+    return result;
+}
+
+/**
+ *
+ * @brief Checks whether `base` to the power of `exponent` is greater than `limit`, without overflowing.
+ *
+ * @param base The base.
+ * @param exponent The positive exponent.
+ * @param limit The bound being compared against.
+ *
+ * @return `true` if the power is greater than `limit`, otherwise `false`.
+ *
+ */
+bool bigint::power_exceeds(uint64_t base, int64_t exponent, uint64_t limit)
+{
+    if (base <= 1)
+    {
+        return base > limit;
+    }
+    uint64_t product = 1;
+    for (int64_t i = 0; i < exponent; ++i)
+    {
+        if (product > limit / base)
+        {
+            return true;
+        }
+        product *= base;
+    }
+    return product > limit;
+}
+
+/**
+ *
+ * @brief Computes the integer k-th root of a 64-bit number.
+ *        The floating-point estimate is exact or off by one, and is corrected with overflow-free power checks.
+ *
+ * @param n The non-negative radicand.
+ * @param k The root degree, at least 2.
+ *
+ * @return The largest `r` with `r` to the power of `k` not greater than `n`.
+ *
+ */
+uint64_t bigint::small_root(uint64_t n, int64_t k)
+{
+    uint64_t root = static_cast<uint64_t>(std::pow(static_cast<long double>(n), 1.0L / static_cast<long double>(k)));
+    while (root > 0 && power_exceeds(root, k, n))
+    {
+        --root;
+    }
+    while (!power_exceeds(root + 1, k, n))
+    {
+        ++root;
+    }
+    return root;
+}
+
+/**
+ *
+ * @brief Computes the integer k-th root of a non-negative `bigint` with Newton iteration and precision doubling.
+ *
+ *        The root of the leading digits is computed recursively, where the leading digits keep about half of the
+ *        digits of the root. Shifting that root back gives a starting point slightly above the true root, with half
+ *        of its digits already correct. Each Newton step `x = ((k - 1) * x + n / x^(k - 1)) / k` doubles the number
+ *        of correct digits, so one or two steps finish the job and the total cost is a small multiple of one
+ *        multiplication at full size. Started above the root, the sequence decreases until it reaches the floor of
+ *        the root, where it stops decreasing.
+ *
+ * @param n The non-negative radicand.
+ * @param k The root degree, at least 2.
+ *
+ * @return The largest `r` with `r` to the power of `k` not greater than `n`.
+ *
+ */
+bigint bigint::root_magnitude(const bigint &n, int64_t k)
+{
+    int64_t length_n = static_cast<int64_t>(n.value.size());
+    if (length_n <= 18)
+    {
+        return from_uint64(small_root(n.magnitude_to_uint64(), k));
+    }
+    // 2^k is greater than 16^length_n, hence greater than n, so the root is 1.
+    if (k >= 4 * length_n)
+    {
+        return bigint(int64_t(1));
+    }
+
+    int64_t half = ((length_n + k - 1) / k) / 2;
+    if (half == 0)
+    {
+        bigint root(int64_t(1));
+        while (power(root + bigint(int64_t(1)), k) <= n)
+        {
+            ++root;
+        }
+        return root;
+    }
+
+    bigint leading = n.shift_digits(-k * half);
+    bigint root = (root_magnitude(leading, k) + bigint(int64_t(1))).shift_digits(half);
+    bigint degree(k);
+    bigint degree_minus_one(k - 1);
+    while (true)
+    {
+        bigint quotient;
+        bigint remainder;
+        divide(n, power(root, k - 1), quotient, remainder);
+        bigint next_root;
+        divide(degree_minus_one * root + quotient, degree, next_root, remainder);
+        if (next_root >= root)
+        {
+            break;
+        }
+        root = next_root;
+    }
+    return root;
+}
+
+/**
+ *
+ * @brief Computes the integer square root of a `bigint` object.
+ *
+ * @param n The non-negative radicand.
+ *
+ * @return The largest `r` with `r * r` not greater than `n`.
+ *
+ * @throws std::invalid_argument If `n` is negative.
+ *
+ */
+bigint isqrt(const bigint &n)
+{
+    return iroot(n, 2);
+}
+
+/**
+ *
+ * @brief Computes the integer k-th root of a `bigint` object, truncated toward zero.
+ *        An odd root of a negative number is negative, e.g. `iroot(-30, 3)` is `-3`.
+ *
+ * @param n The radicand.
+ * @param k The root degree, at least 1.
+ *
+ * @return The root of `n` truncated toward zero.
+ *
+ * @throws std::invalid_argument If `k` is less than 1, or `k` is even and `n` is negative.
+ *
+ */
+bigint iroot(const bigint &n, int64_t k)
+{
+    if (k < 1)
+    {
+        throw std::invalid_argument("The root degree must be at least 1.");
+    }
+    if (n.is_negative && k % 2 == 0)
+    {
+        throw std::invalid_argument("An even root of a negative number is not an integer.");
+    }
+    if (k == 1)
+    {
+        return n;
+    }
+    bigint root = bigint::root_magnitude(n.is_negative ? -n : n, k);
+    return n.is_negative ? -root : root;
+}
+
+/**
+ *
+ * @brief Computes the remainder of the absolute value of a `bigint` object modulo a small positive number,
+ *        without building the quotient.
+ *
+ * @param modulus The positive modulus, less than 2^59 so that `remainder * 10 + digit` cannot overflow.
+ *
+ * @return The remainder in the range [0, modulus).
+ *
+ */
+int64_t bigint::magnitude_mod(int64_t modulus) const
+{
+    int64_t remainder = 0;
+    for (size_t i = value.size(); i > 0; --i)
+    {
+        remainder = (remainder * 10 + value[i - 1]) % modulus;
+    }
+    return remainder;
+}
+
+/**
+ *
+ * @brief Rules out most non-negative numbers that are not k-th powers from their residues modulo four primes `q`
+ *        with `q = 1 (mod k)`. Modulo such a prime only one nonzero residue in k is a k-th power, exactly those `r`
+ *        with `r^((q - 1) / k) = 1 (mod q)`, so a number that is not a k-th power passes all four primes with a
+ *        probability of about `1 / k^4`. Each prime costs one pass over the digits and no multiplication at full size.
+ *
+ * @param n The non-negative `bigint` being checked.
+ * @param k The exponent, at least 2.
+ *
+ * @return `false` if `n` is certainly not a k-th power, `true` if it may be one.
+ *
+ */
+bool bigint::may_be_power(const bigint &n, int64_t k)
+{
+    int found = 0;
+    for (int64_t q = 2 * k + 1; found < 4; q += 2 * k)
+    {
+        bool is_prime = true;
+        for (int64_t p = 3; p * p <= q; p += 2)
+        {
+            if (q % p == 0)
+            {
+                is_prime = false;
+                break;
+            }
+        }
+        if (!is_prime)
+        {
+            continue;
+        }
+        ++found;
+        // q stays far below 2^31 for any exponent that fits in memory, so the products below fit in 64 bits.
+        int64_t base = n.magnitude_mod(q);
+        if (base == 0)
+        {
+            continue;
+        }
+        int64_t result = 1;
+        for (int64_t exponent = (q - 1) / k; exponent > 0; exponent /= 2)
+        {
+            if (exponent % 2 == 1)
+            {
+                result = result * base % q;
+            }
+            base = base * base % q;
+        }
+        if (result != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ *
+ * @brief Checks whether a `bigint` object is the square of an integer.
+ *        Most non-squares are rejected from their last two digits alone, because only 22 of the 100 possible
+ *        endings can end a square, and most of the rest from their residues modulo a few small primes.
+ *        Only the survivors are confirmed with `isqrt`.
+ *
+ * @param n The `bigint` being checked.
+ *
+ * @return `true` if `n` is a perfect square, otherwise `false`.
+ *
+ */
+bool is_perfect_square(const bigint &n)
+{
+    if (n.is_negative)
+    {
+        return false;
+    }
+    static const bool is_square_ending[100] = {
+        1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+        0, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+        0, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+        0, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+        0, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
+    int64_t ending = n.value[0] + ((n.value.size() > 1) ? n.value[1] * 10 : 0);
+    if (!is_square_ending[ending] || !bigint::may_be_power(n, 2))
+    {
+        return false;
+    }
+    bigint root = isqrt(n);
+    return root * root == n;
+}
+
+/**
+ *
+ * @brief Checks whether a `bigint` object is a perfect power, i.e. `a` to the power of `k` for some integer `a` and `k >= 2`.
+ *        Only prime exponents need to be tried, since `a^(p*m)` is also `(a^m)^p`. A negative number is a perfect power
+ *        when its absolute value is an odd perfect power. 0, 1 and -1 count as perfect powers.
+ *
+ *        Each exponent is first screened by `may_be_power`, which costs a few passes over the digits, and the full
+ *        size root is only computed for the rare exponents that survive it.
+ *
+ * @param n The `bigint` being checked.
+ *
+ * @return `true` if `n` is a perfect power, otherwise `false`.
+ *
+ */
+bool is_perfect_power(const bigint &n)
+{
+    bigint magnitude = n.is_negative ? -n : n;
+    if (magnitude.value.size() == 1 && magnitude.value[0] <= 1)
+    {
+        return true;
+    }
+    if (!n.is_negative && is_perfect_square(magnitude))
+    {
+        return true;
+    }
+    // The number is less than 2^(3.33 * digits), so no greater exponent can have a root of at least 2.
+    int64_t max_exponent = static_cast<int64_t>(3.33 * static_cast<double>(magnitude.value.size())) + 1;
+    for (int64_t k = 3; k <= max_exponent; k += 2)
+    {
+        bool is_prime = true;
+        for (int64_t p = 3; p * p <= k; p += 2)
+        {
+            if (k % p == 0)
+            {
+                is_prime = false;
+                break;
+            }
+        }
+        if (!is_prime || !bigint::may_be_power(magnitude, k))
+        {
+            continue;
+        }
+        bigint root = bigint::root_magnitude(magnitude, k);
+        if (root.value.size() == 1 && root.value[0] == 1)
+        {
+            break;
+        }
+        if (bigint::power(root, k) == magnitude)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ *
+ * @brief Keeps the lowest digits of a non-negative `bigint` object, i.e. reduces it modulo a power of ten.
+ *
+ * @param count The number of digits kept.
+ *
+ * @return A new `bigint` representing the value modulo 10 to the power of `count`.
+ *
+ */
+bigint bigint::low_digits(size_t count) const
+{
+    bigint low;
+    if (count < value.size())
+    {
+        low.value.assign(value.begin(), value.begin() + count);
+        while (low.value.size() > 1 && low.value.back() == 0)
+        {
+            low.value.pop_back();
+        }
+        if (low.value.empty())
+        {
+            low.value.push_back(0);
+        }
+    }
+    else
+    {
+        low.value = value;
+    }
+    return low;
+}
+
+/**
+ *
+ * @brief Divides a non-negative `bigint` object by a small positive integer in one pass over the digits.
+ *
+ * @param dividend The non-negative `bigint` being divided.
+ * @param divisor The positive divisor, below 10^17.
+ * @param remainder Receives the remainder.
+ *
+ * @return A new `bigint` representing the quotient.
+ *
+ */
+bigint bigint::divide_small(const bigint &dividend, int64_t divisor, int64_t &remainder)
+{
+    bigint quotient;
+    quotient.value.resize(dividend.value.size());
+    remainder = 0;
+    for (size_t i = dividend.value.size(); i > 0; --i)
+    {
+        int64_t current = remainder * 10 + dividend.value[i - 1];
+        quotient.value[i - 1] = current / divisor;
+        remainder = current % divisor;
+    }
+    while (quotient.value.size() > 1 && quotient.value.back() == 0)
+    {
+        quotient.value.pop_back();
+    }
+    return quotient;
+}
+
+/**
+ *
+ * @brief Reduces a `bigint` object modulo a positive modulus, always returning a value in [0, modulus).
+ *
+ * @param num The `bigint` being reduced.
+ * @param modulus The positive modulus.
+ *
+ * @return A new `bigint` in the range [0, modulus).
+ *
+ */
+bigint bigint::mod_floor(const bigint &num, const bigint &modulus)
+{
+    bigint quotient;
+    bigint remainder;
+    divide(num, modulus, quotient, remainder);
+    if (remainder.is_negative)
+    {
+        remainder += modulus;
+    }
+    return remainder;
+}
+
+/**
+ *
+ * @brief Returns the primes below 1000, used for trial division.
+ *        The table is built once with a sieve of Eratosthenes.
+ *
+ * @return A reference to the table of primes, in increasing order.
+ *
+ */
+const std::vector<int64_t> &bigint::small_primes()
+{
+    static const std::vector<int64_t> primes = []()
+    {
+        std::vector<int64_t> table;
+        std::vector<bool> is_composite(1000, false);
+        for (int64_t i = 2; i < 1000; ++i)
+        {
+            if (!is_composite[i])
+            {
+                table.push_back(i);
+                for (int64_t j = i * i; j < 1000; j += i)
+                {
+                    is_composite[j] = true;
+                }
+            }
+        }
+        return table;
+    }();
+    return primes;
+}
+
+/**
+ *
+ * @brief Computes the Jacobi symbol (a/n) of a small integer over a large odd positive `bigint`.
+ *        Quadratic reciprocity moves the work to (n mod a / a), after which only 64-bit integers remain.
+ *
+ * @param a The small integer on top.
+ * @param n The odd positive `bigint` at the bottom.
+ *
+ * @return The Jacobi symbol, -1, 0 or 1.
+ *
+ */
+int bigint::jacobi(int64_t a, const bigint &n)
+{
+    int result = 1;
+    int64_t n_mod_8 = 0;
+    divide_small(n, 8, n_mod_8);
+    if (a < 0)
+    {
+        a = -a;
+        if (n_mod_8 % 4 == 3)
+        {
+            result = -result;
+        }
+    }
+    while (a != 0 && a % 2 == 0)
+    {
+        a /= 2;
+        if (n_mod_8 == 3 || n_mod_8 == 5)
+        {
+            result = -result;
+        }
+    }
+    if (a == 0)
+    {
+        return 0;
+    }
+    if (a == 1)
+    {
+        return result;
+    }
+    if (a % 4 == 3 && n_mod_8 % 4 == 3)
+    {
+        result = -result;
+    }
+
+    int64_t top = 0;
+    divide_small(n, a, top);
+    int64_t bottom = a;
+    while (top != 0)
+    {
+        while (top % 2 == 0)
+        {
+            top /= 2;
+            if (bottom % 8 == 3 || bottom % 8 == 5)
+            {
+                result = -result;
+            }
+        }
+        std::swap(top, bottom);
+        if (top % 4 == 3 && bottom % 4 == 3)
+        {
+            result = -result;
+        }
+        top %= bottom;
+    }
+    return (bottom == 1) ? result : 0;
+}
+
+/**
+ *
+ * @class bigint_montgomery
+ *
+ * @brief `bigint_montgomery` is a reusable context for modular arithmetic with Montgomery reduction.
+ *        The Montgomery radix is R = 10^k, where k is the number of digits of the modulus. Because `value` stores
+ *        decimal digits, the reduction clears the lowest digit one at a time and dividing by R only drops digits,
+ *        so no long division is needed after the context is built. The modulus must be greater than 1 and coprime to 10.
+ *
+ *        Numbers in Montgomery form are `a * R mod modulus`. `multiply`, `add`, `subtract`, `halve` and `power`
+ *        take and return numbers in that form, all in [0, modulus), and throw `std::invalid_argument` for an operand
+ *        outside that range. The const methods do not modify the context, so one context can be shared between threads.
+ *
+ */
+class bigint_montgomery
+{
+public:
+    explicit bigint_montgomery(const bigint &modulus);
+    const bigint &modulus() const;
+    const bigint &one() const;
+    bigint to_montgomery(const bigint &num) const;
+    bigint from_montgomery(const bigint &num) const;
+    bigint multiply(const bigint &lhs, const bigint &rhs) const;
+    bigint add(const bigint &lhs, const bigint &rhs) const;
+    bigint subtract(const bigint &lhs, const bigint &rhs) const;
+    bigint halve(const bigint &num) const;
+    bigint power(const bigint &base, const bigint &exponent) const;
+
+private:
+    bigint reduce(std::vector<int64_t> &columns) const;
+    void check_operand(const bigint &num) const;
+
+    /**
+     *
+     * @brief `modulus_num` is the odd modulus, coprime to 10.
+     *
+     */
+    bigint modulus_num;
+
+    /**
+     *
+     * @brief `length` is the number of digits k of the modulus, so the Montgomery radix is R = 10^k.
+     *
+     */
+    size_t length;
+
+    /**
+     *
+     * @brief `negative_inverse_digit` is -modulus^(-1) mod 10, used for every digit cleared by the reduction.
+     *
+     */
+    int64_t negative_inverse_digit;
+
+    /**
+     *
+     * @brief `r_squared` is R^2 mod modulus, used to move numbers into Montgomery form.
+     *
+     */
+    bigint r_squared;
+
+    /**
+     *
+     * @brief `montgomery_one` is R mod modulus, the number 1 in Montgomery form.
+     *
+     */
+    bigint montgomery_one;
+};
+
+/**
+ *
+ * @brief A constructor that prepares the Montgomery context of a modulus.
+ *        The reduction only needs the inverse of the lowest digit modulo 10. R mod modulus and R^2 mod modulus
+ *        are the only long divisions.
+ *
+ * @param modulus The modulus, greater than 1 and coprime to 10.
+ *
+ * @throws std::invalid_argument If the modulus is not greater than 1, or shares a factor with 10.
+ *
+ */
+bigint_montgomery::bigint_montgomery(const bigint &modulus)
+{
+    if (modulus.is_negative || (modulus.value.size() == 1 && modulus.value[0] <= 1) || modulus.value[0] % 2 == 0 || modulus.value[0] == 5)
+    {
+        throw std::invalid_argument("The Montgomery modulus must be greater than 1 and coprime to 10.");
+    }
+    modulus_num = modulus;
+    length = modulus.value.size();
+
+    // The inverses modulo 10 of the digits 1, 3, 7 and 9 are 1, 7, 3 and 9.
+    static const int64_t digit_inverse[10] = {0, 1, 0, 7, 0, 0, 0, 3, 0, 9};
+    negative_inverse_digit = 10 - digit_inverse[modulus.value[0]];
+
+    montgomery_one = bigint::mod_floor(bigint(int64_t(1)).shift_digits(static_cast<int64_t>(length)), modulus_num);
+    r_squared = bigint::mod_floor(bigint(int64_t(1)).shift_digits(static_cast<int64_t>(2 * length)), modulus_num);
+}
+
+/**
+ *
+ * @brief Returns the modulus of the context.
+ *
+ */
+const bigint &bigint_montgomery::modulus() const
+{
+    return modulus_num;
+}
+
+/**
+ *
+ * @brief Returns the number 1 in Montgomery form.
+ *
+ */
+const bigint &bigint_montgomery::one() const
+{
+    return montgomery_one;
+}
+
+/**
+ *
+ * @brief Computes num / R mod modulus for 0 <= num < modulus * R, one digit at a time (REDC).
+ *        For i = 0, ..., k - 1, adding m_i * modulus * 10^i with m_i = num_i * negative_inverse_digit mod 10
+ *        clears digit i, so after k steps the number is a multiple of R and the division only drops k digits.
+ *        The columns hold unnormalized digit sums, and only the carry out of the column being cleared is propagated,
+ *        so each step is a single multiply-add pass over the modulus.
+ *
+ * @param columns The column sums of num, lowest first; they are used as the working buffer.
+ *
+ * @return A new `bigint` in [0, modulus).
+ *
+ */
+bigint bigint_montgomery::reduce(std::vector<int64_t> &columns) const
+{
+    const std::vector<int64_t> &modulus_digits = modulus_num.value;
+    columns.resize(2 * length + 1, 0);
+    for (size_t i = 0; i < length; ++i)
+    {
+        int64_t m = columns[i] % 10 * negative_inverse_digit % 10;
+        int64_t *column = columns.data() + i;
+        for (size_t j = 0; j < length; ++j)
+        {
+            column[j] += m * modulus_digits[j];
+        }
+        columns[i + 1] += columns[i] / 10;
+    }
+    for (size_t i = length; i < 2 * length; ++i)
+    {
+        columns[i + 1] += columns[i] / 10;
+        columns[i] %= 10;
+    }
+
+    bigint reduced;
+    reduced.value.assign(columns.begin() + static_cast<std::ptrdiff_t>(length), columns.end());
+    while (reduced.value.size() > 1 && reduced.value.back() == 0)
+    {
+        reduced.value.pop_back();
+    }
+    if (reduced >= modulus_num)
+    {
+        reduced -= modulus_num;
+    }
+    return reduced;
+}
+
+/**
+ *
+ * @brief Converts a `bigint` object into Montgomery form.
+ *
+ * @param num Any `bigint`; it is first reduced into [0, modulus).
+ *
+ * @return A new `bigint` representing num * R mod modulus.
+ *
+ */
+bigint bigint_montgomery::to_montgomery(const bigint &num) const
+{
+    bigint reduced = num;
+    if (num.is_negative || num >= modulus_num)
+    {
+        reduced = bigint::mod_floor(num, modulus_num);
+    }
+    return multiply(reduced, r_squared);
+}
+
+/**
+ *
+ * @brief Checks that a number in Montgomery form lies in [0, modulus).
+ *        The reduction works in a buffer of 2k + 1 columns, which only holds products of such numbers.
+ *
+ * @param num The number being checked.
+ *
+ * @throws std::invalid_argument If `num` is negative or not less than the modulus.
+ *
+ */
+void bigint_montgomery::check_operand(const bigint &num) const
+{
+    if (num.is_negative || num >= modulus_num)
+    {
+        throw std::invalid_argument("A number in Montgomery form must be in [0, modulus).");
+    }
+}
+
+/**
+ *
+ * @brief Converts a number in Montgomery form back to an ordinary `bigint` in [0, modulus).
+ *
+ * @param num The number in Montgomery form, in [0, modulus).
+ *
+ * @return A new `bigint` representing num / R mod modulus.
+ *
+ * @throws std::invalid_argument If `num` is not in [0, modulus).
+ *
+ */
+bigint bigint_montgomery::from_montgomery(const bigint &num) const
+{
+    check_operand(num);
+    std::vector<int64_t> columns = num.value;
+    return reduce(columns);
+}
+
+/**
+ *
+ * @brief Multiplies two numbers in Montgomery form.
+ *        The product is accumulated as column sums without carries and handed straight to the reduction,
+ *        so no intermediate `bigint` is built and no digit is divided by 10 inside the inner loop.
+ *        A column sum is at most 81 * k per pass, which stays far below 2^63 for any size that fits in memory.
+ *
+ * @param lhs The left-hand side number in Montgomery form, in [0, modulus).
+ * @param rhs The right-hand side number in Montgomery form, in [0, modulus).
+ *
+ * @return The product in Montgomery form.
+ *
+ * @throws std::invalid_argument If an operand is not in [0, modulus).
+ *
+ */
+bigint bigint_montgomery::multiply(const bigint &lhs, const bigint &rhs) const
+{
+    check_operand(lhs);
+    check_operand(rhs);
+    std::vector<int64_t> columns(2 * length + 1, 0);
+    for (size_t i = 0; i < lhs.value.size(); ++i)
+    {
+        int64_t digit = lhs.value[i];
+        if (digit == 0)
+        {
+            continue;
+        }
+        int64_t *column = columns.data() + i;
+        for (size_t j = 0; j < rhs.value.size(); ++j)
+        {
+            column[j] += digit * rhs.value[j];
+        }
+    }
+    return reduce(columns);
+}
+
+/**
+ *
+ * @brief Adds two numbers in Montgomery form.
+ *
+ * @param lhs The left-hand side number in Montgomery form, in [0, modulus).
+ * @param rhs The right-hand side number in Montgomery form, in [0, modulus).
+ *
+ * @return The sum in Montgomery form.
+ *
+ * @throws std::invalid_argument If an operand is not in [0, modulus).
+ *
+ */
+bigint bigint_montgomery::add(const bigint &lhs, const bigint &rhs) const
+{
+    check_operand(lhs);
+    check_operand(rhs);
+    bigint sum = lhs + rhs;
+    if (sum >= modulus_num)
+    {
+        sum -= modulus_num;
+    }
+    return sum;
+}
+
+/**
+ *
+ * @brief Subtracts two numbers in Montgomery form.
+ *
+ * @param lhs The left-hand side number in Montgomery form, in [0, modulus).
+ * @param rhs The right-hand side number in Montgomery form, in [0, modulus).
+ *
+ * @return The difference in Montgomery form.
+ *
+ * @throws std::invalid_argument If an operand is not in [0, modulus).
+ *
+ */
+bigint bigint_montgomery::subtract(const bigint &lhs, const bigint &rhs) const
+{
+    check_operand(lhs);
+    check_operand(rhs);
+    bigint difference = lhs - rhs;
+    if (difference.is_negative)
+    {
+        difference += modulus_num;
+    }
+    return difference;
+}
+
+/**
+ *
+ * @brief Divides a number in Montgomery form by 2 modulo the odd modulus.
+ *        An odd number is made even by adding the modulus before halving.
+ *
+ * @param num The number in Montgomery form, in [0, modulus).
+ *
+ * @return num / 2 mod modulus, in Montgomery form.
+ *
+ * @throws std::invalid_argument If `num` is not in [0, modulus).
+ *
+ */
+bigint bigint_montgomery::halve(const bigint &num) const
+{
+    check_operand(num);
+    int64_t remainder = 0;
+    if (num.value[0] % 2 == 1)
+    {
+        return bigint::divide_small(num + modulus_num, 2, remainder);
+    }
+    return bigint::divide_small(num, 2, remainder);
+}
+
+/**
+ *
+ * @brief Raises a number in Montgomery form to a non-negative power.
+ *        The exponent is walked one decimal digit at a time: the running result is raised to the 10th power
+ *        with four multiplications, then multiplied by a precomputed power base^digit.
+ *
+ * @param base The base in Montgomery form, in [0, modulus).
+ * @param exponent The non-negative exponent, as an ordinary `bigint`.
+ *
+ * @return base^exponent in Montgomery form.
+ *
+ * @throws std::invalid_argument If the base is not in [0, modulus), or the exponent is negative.
+ *
+ */
+bigint bigint_montgomery::power(const bigint &base, const bigint &exponent) const
+{
+    check_operand(base);
+    if (exponent.is_negative)
+    {
+        throw std::invalid_argument("The exponent must be non-negative.");
+    }
+    bigint table[10];
+    table[0] = montgomery_one;
+    for (int i = 1; i < 10; ++i)
+    {
+        table[i] = multiply(table[i - 1], base);
+    }
+    bigint result = montgomery_one;
+    for (size_t i = exponent.value.size(); i > 0; --i)
+    {
+        if (i != exponent.value.size())
+        {
+            bigint square = multiply(result, result);
+            bigint fourth = multiply(square, square);
+            bigint fifth = multiply(fourth, result);
+            result = multiply(fifth, fifth);
+        }
+        if (exponent.value[i - 1] != 0)
+        {
+            result = multiply(result, table[exponent.value[i - 1]]);
+        }
+    }
+    return result;
+}
+
+/**
+ *
+ * @brief Runs one Miller-Rabin round: checks whether the modulus of the context is a strong probable prime to a base.
+ *
+ * @param context The Montgomery context of the odd candidate n.
+ * @param base The base, in [2, n - 2].
+ * @param odd_part The odd number d with n - 1 = d * 2^twos.
+ * @param twos The exponent of 2 in n - 1.
+ *
+ * @return `false` if the base proves n composite, otherwise `true`.
+ *
+ */
+bool bigint::is_strong_probable_prime(const bigint_montgomery &context, const bigint &base, const bigint &odd_part, int64_t twos)
+{
+    bigint minus_one = context.subtract(bigint(), context.one());
+    bigint x = context.power(context.to_montgomery(base), odd_part);
+    if (x == context.one() || x == minus_one)
+    {
+        return true;
+    }
+    for (int64_t r = 1; r < twos; ++r)
+    {
+        x = context.multiply(x, x);
+        if (x == minus_one)
+        {
+            return true;
+        }
+        if (x == context.one())
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ *
+ * @brief Runs the strong Lucas probable prime test with Selfridge's parameters, the second half of BPSW.
+ *        D is the first of 5, -7, 9, -11, ... with Jacobi symbol (D/n) = -1, P = 1 and Q = (1 - D) / 4.
+ *        The Lucas sequences are computed in Montgomery form, walking the binary digits of the odd part of n + 1.
+ *
+ * @param n The odd candidate, not a perfect square and free of small factors.
+ * @param context The Montgomery context of n.
+ *
+ * @return `false` if the test proves n composite, otherwise `true`.
+ *
+ */
+bool bigint::is_strong_lucas_probable_prime(const bigint &n, const bigint_montgomery &context)
+{
+    int64_t d = 5;
+    while (true)
+    {
+        int symbol = jacobi(d, n);
+        if (symbol == -1)
+        {
+            break;
+        }
+        if (symbol == 0)
+        {
+            return false;
+        }
+        d = (d > 0) ? -(d + 2) : -(d - 2);
+    }
+    int64_t q = (1 - d) / 4;
+
+    int64_t remainder = 0;
+    bigint odd_part = n + bigint(int64_t(1));
+    int64_t twos = 0;
+    while (odd_part.value[0] % 2 == 0)
+    {
+        odd_part = divide_small(odd_part, 2, remainder);
+        ++twos;
+    }
+    std::vector<int64_t> bits;
+    for (bigint rest = odd_part; !rest.is_zero(); rest = divide_small(rest, 2, remainder))
+    {
+        bits.push_back(rest.value[0] % 2);
+    }
+
+    bigint montgomery_d = context.to_montgomery(bigint(d));
+    bigint montgomery_q = context.to_montgomery(bigint(q));
+    bigint u = context.one();
+    bigint v = context.one();
+    bigint q_power = montgomery_q;
+    for (size_t i = bits.size() - 1; i > 0; --i)
+    {
+        u = context.multiply(u, v);
+        v = context.subtract(context.multiply(v, v), context.add(q_power, q_power));
+        q_power = context.multiply(q_power, q_power);
+        if (bits[i - 1] == 1)
+        {
+            bigint next_u = context.halve(context.add(u, v));
+            v = context.halve(context.add(context.multiply(montgomery_d, u), v));
+            u = next_u;
+            q_power = context.multiply(q_power, montgomery_q);
+        }
+    }
+    if (u.is_zero() || v.is_zero())
+    {
+        return true;
+    }
+    for (int64_t r = 1; r < twos; ++r)
+    {
+        v = context.subtract(context.multiply(v, v), context.add(q_power, q_power));
+        q_power = context.multiply(q_power, q_power);
+        if (v.is_zero())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ *
+ * @brief Computes the modular inverse of a `bigint` object with the extended Euclidean algorithm.
+ *
+ * @param a The number being inverted.
+ * @param m The positive modulus.
+ *
+ * @return The `x` in [0, m) with a * x = 1 (mod m).
+ *
+ * @throws std::invalid_argument If `m` is not positive, or `a` and `m` are not coprime.
+ *
+ */
+bigint modinv(const bigint &a, const bigint &m)
+{
+    if (m.is_negative || m.is_zero())
+    {
+        throw std::invalid_argument("The modulus must be positive.");
+    }
+    bigint old_r = bigint::mod_floor(a, m);
+    bigint r = m;
+    bigint old_s(int64_t(1));
+    bigint s;
+    while (!r.is_zero())
+    {
+        bigint quotient;
+        bigint remainder;
+        bigint::divide(old_r, r, quotient, remainder);
+        old_r = r;
+        r = remainder;
+        bigint next_s = old_s - quotient * s;
+        old_s = s;
+        s = next_s;
+    }
+    if (m.value.size() == 1 && m.value[0] == 1)
+    {
+        return bigint();
+    }
+    if (old_r.value.size() != 1 || old_r.value[0] != 1)
+    {
+        throw std::invalid_argument("The number is not invertible modulo m.");
+    }
+    return bigint::mod_floor(old_s, m);
+}
+
+/**
+ *
+ * @brief Checks whether a `bigint` object is probably prime.
+ *
+ *        The candidate is first divided by every prime below 1000, which settles every number below 10^6.
+ *        Larger candidates go through BPSW: a Miller-Rabin round to base 2 followed by a strong Lucas test,
+ *        which has no known counterexample. `rounds` extra Miller-Rabin rounds with random bases follow, each
+ *        letting a composite through with probability at most 1/4. All modular arithmetic shares one Montgomery
+ *        context. For candidates of 600 digits (about 2000 bits) or more, the extra rounds are spread over the
+ *        hardware threads, and every thread stops as soon as one round finds a witness.
+ *
+ * @param n The `bigint` being checked.
+ * @param rounds The number of extra Miller-Rabin rounds with random bases.
+ *
+ * @return `false` if `n` is certainly composite or below 2, `true` if it is prime or a probable prime.
+ *
+ */
+bool is_probable_prime(const bigint &n, int rounds = 8)
+{
+    if (n.is_negative || (n.value.size() == 1 && n.value[0] < 2))
+    {
+        return false;
+    }
+    bool is_small = n.value.size() <= 6;
+    uint64_t small_value = is_small ? n.magnitude_to_uint64() : 0;
+    for (int64_t prime : bigint::small_primes())
+    {
+        if (is_small && small_value == static_cast<uint64_t>(prime))
+        {
+            return true;
+        }
+        int64_t remainder = 0;
+        bigint::divide_small(n, prime, remainder);
+        if (remainder == 0)
+        {
+            return false;
+        }
+    }
+    if (is_small)
+    {
+        return true;
+    }
+
+    bigint_montgomery context(n);
+    bigint n_minus_one = n - bigint(int64_t(1));
+    bigint odd_part = n_minus_one;
+    int64_t twos = 0;
+    int64_t remainder = 0;
+    while (odd_part.value[0] % 2 == 0)
+    {
+        odd_part = bigint::divide_small(odd_part, 2, remainder);
+        ++twos;
+    }
+    if (!bigint::is_strong_probable_prime(context, bigint(int64_t(2)), odd_part, twos))
+    {
+        return false;
+    }
+    if (is_perfect_square(n) || !bigint::is_strong_lucas_probable_prime(n, context))
+    {
+        return false;
+    }
+    if (rounds <= 0)
+    {
+        return true;
+    }
+
+    // Bases are drawn in [2, n - 2] from random digits a little longer than n, so the reduction is nearly uniform.
+    std::random_device seed;
+    std::mt19937_64 generator(seed());
+    std::uniform_int_distribution<int> digit(0, 9);
+    bigint base_range = n - bigint(int64_t(3));
+    std::vector<bigint> bases;
+    for (int i = 0; i < rounds; ++i)
+    {
+        std::string digits(n.value.size() + 2, '0');
+        for (char &c : digits)
+        {
+            c = static_cast<char>('0' + digit(generator));
+        }
+        bases.push_back(bigint::mod_floor(bigint(digits), base_range) + bigint(int64_t(2)));
+    }
+
+    size_t thread_count = 1;
+    if (n.value.size() >= 600)
+    {
+        thread_count = std::min<size_t>(bases.size(), std::max(1u, std::thread::hardware_concurrency()));
+    }
+    std::atomic<bool> is_composite(false);
+    auto run_rounds = [&](size_t first)
+    {
+        for (size_t i = first; i < bases.size() && !is_composite.load(std::memory_order_relaxed); i += thread_count)
+        {
+            if (!bigint::is_strong_probable_prime(context, bases[i], odd_part, twos))
+            {
+                is_composite.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(run_rounds, i);
+    }
+    run_rounds(0);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    return !is_composite.load();
+}
+
+/**
+ *
+ * @brief Multiplies `factors[first, last)` as a balanced binary tree, so both operands of every multiplication have
+ *        about the same size. While `threads` is greater than 1, the left half of a large range runs asynchronously
+ *        and the two halves share the threads.
+ *
+ * @param factors The factors.
+ * @param first The index of the first factor.
+ * @param last The index one past the last factor.
+ * @param threads The number of threads this subtree may use.
+ *
+ * @return A new `bigint` representing the product, 1 for an empty range.
+ *
+ */
+bigint bigint_product_tree(const std::vector<bigint> &factors, size_t first, size_t last, unsigned threads)
+{
+    if (last - first == 0)
+    {
+        return bigint(int64_t(1));
+    }
+    if (last - first == 1)
+    {
+        return factors[first];
+    }
+    size_t middle = first + (last - first) / 2;
+    if (threads > 1 && last - first >= 64)
+    {
+        std::future<bigint> left = std::async(std::launch::async, bigint_product_tree, std::cref(factors), first, middle, threads / 2);
+        bigint right = bigint_product_tree(factors, middle, last, threads - threads / 2);
+        return left.get() * right;
+    }
+    return bigint_product_tree(factors, first, middle, 1) * bigint_product_tree(factors, middle, last, 1);
+}
+
+/**
+ *
+ * @brief Multiplies a list of `bigint` objects with a balanced product tree, using the hardware threads for large lists.
+ *
+ * @param factors The factors.
+ *
+ * @return A new `bigint` representing the product, 1 for an empty list.
+ *
+ */
+bigint product(const std::vector<bigint> &factors)
+{
+    return bigint_product_tree(factors, 0, factors.size(), std::max(1u, std::thread::hardware_concurrency()));
+}
+
+/**
+ *
+ * @brief Multiplies a range of values convertible to `bigint` with a balanced product tree.
+ *
+ * @param first The iterator to the first value.
+ * @param last The iterator one past the last value.
+ *
+ * @return A new `bigint` representing the product, 1 for an empty range.
+ *
+ */
+template <typename Iterator>
+bigint product(Iterator first, Iterator last)
+{
+    std::vector<bigint> factors;
+    for (; first != last; ++first)
+    {
+        factors.push_back(bigint(*first));
+    }
+    return product(factors);
+}
+
+/**
+ *
+ * @brief Lists the primes up to a limit with a sieve of Eratosthenes.
+ *
+ * @param limit The largest number checked.
+ *
+ * @return The primes up to `limit`, in increasing order.
+ *
+ */
+std::vector<int64_t> bigint_prime_sieve(int64_t limit)
+{
+    std::vector<int64_t> primes;
+    if (limit < 2)
+    {
+        return primes;
+    }
+    std::vector<bool> is_composite(static_cast<size_t>(limit) + 1, false);
+    for (int64_t i = 2; i <= limit; ++i)
+    {
+        if (!is_composite[i])
+        {
+            primes.push_back(i);
+            for (int64_t j = i * i; j <= limit; j += i)
+            {
+                is_composite[j] = true;
+            }
+        }
+    }
+    return primes;
+}
+
+/**
+ *
+ * @brief Packs small factors into as few `bigint` leaves as possible.
+ *        Consecutive factors are multiplied as 64-bit integers until the next one would overflow, so the product
+ *        tree starts from leaves of about 18 digits instead of one leaf per small factor.
+ *
+ * @param factors The positive factors, each below 2^63.
+ * @param leaves Receives the packed leaves.
+ *
+ */
+void bigint_pack_factors(const std::vector<int64_t> &factors, std::vector<bigint> &leaves)
+{
+    int64_t packed = 1;
+    for (int64_t factor : factors)
+    {
+        if (packed > INT64_MAX / factor)
+        {
+            leaves.push_back(bigint(packed));
+            packed = 1;
+        }
+        packed *= factor;
+    }
+    if (packed > 1)
+    {
+        leaves.push_back(bigint(packed));
+    }
+}
+
+/**
+ *
+ * @brief Computes the swinging factorial swing(n) = n! / ((n / 2)!)^2 from its prime factorization.
+ *        The exponent of a prime p in swing(n) is the number of odd values among n / p, n / p^2, n / p^3, ...
+ *
+ * @param n The non-negative integer.
+ * @param primes The primes up to at least `n`, in increasing order.
+ *
+ * @return A new `bigint` representing the swinging factorial of `n`.
+ *
+ */
+bigint bigint_swing(int64_t n, const std::vector<int64_t> &primes)
+{
+    std::vector<int64_t> factors;
+    for (int64_t p : primes)
+    {
+        if (p > n)
+        {
+            break;
+        }
+        int64_t q = n;
+        while (q >= p)
+        {
+            q /= p;
+            if (q % 2 == 1)
+            {
+                factors.push_back(p);
+            }
+        }
+    }
+    std::vector<bigint> leaves;
+    bigint_pack_factors(factors, leaves);
+    return product(leaves);
+}
+
+/**
+ *
+ * @brief Computes n! with the prime-swing algorithm, n! = ((n / 2)!)^2 * swing(n), for an already sieved prime table.
+ *
+ * @param n The non-negative integer.
+ * @param primes The primes up to at least `n`, in increasing order.
+ *
+ * @return A new `bigint` representing n!.
+ *
+ */
+bigint bigint_swing_factorial(int64_t n, const std::vector<int64_t> &primes)
+{
+    if (n < 512)
+    {
+        std::vector<int64_t> factors;
+        for (int64_t i = 2; i <= n; ++i)
+        {
+            factors.push_back(i);
+        }
+        std::vector<bigint> leaves;
+        bigint_pack_factors(factors, leaves);
+        return product(leaves);
+    }
+    bigint half_factorial = bigint_swing_factorial(n / 2, primes);
+    return half_factorial * half_factorial * bigint_swing(n, primes);
+}
+
+/**
+ *
+ * @brief Computes the factorial n! of a non-negative integer.
+ *        Below 512 the numbers 2 to n are multiplied with a balanced product tree. From 512 on, the prime-swing
+ *        recursion n! = ((n / 2)!)^2 * swing(n) is used, where the swinging factorial swing(n) is a product of prime powers.
+ *        It needs far fewer multiplications than the plain product of 2 to n.
+ *
+ * @param n The non-negative integer.
+ *
+ * @return A new `bigint` representing n!.
+ *
+ * @throws std::invalid_argument If `n` is negative.
+ *
+ */
+bigint factorial(int64_t n)
+{
+    if (n < 0)
+    {
+        throw std::invalid_argument("The factorial is only defined for non-negative integers.");
+    }
+    return bigint_swing_factorial(n, (n < 512) ? std::vector<int64_t>() : bigint_prime_sieve(n));
+}
+
+/**
+ *
+ * @brief Computes the binomial coefficient C(n, k), using C(n, k) = C(n, n - k) to make k the smaller side.
+ *
+ *        When k^2 is at most n / 16, the result is the product of n - k + 1, ..., n divided exactly by k!.
+ *        The work grows with k^2 and does not depend on n, so e.g. C(10^18, 2) is immediate.
+ *
+ *        Otherwise the result is built from its prime factorization. By Legendre's formula, the exponent of a prime p
+ *        in C(n, k) is the sum over p^i of n / p^i - k / p^i - (n - k) / p^i, so no division of large numbers is needed.
+ *        This sieves the primes up to n, which costs time and memory in proportion to n and pays off once k is larger.
+ *
+ * @param n The non-negative integer on top.
+ * @param k The integer at the bottom.
+ *
+ * @return A new `bigint` representing C(n, k), 0 if `k` is negative or greater than `n`.
+ *
+ * @throws std::invalid_argument If `n` is negative.
+ *
+ */
+bigint binomial(int64_t n, int64_t k)
+{
+    if (n < 0)
+    {
+        throw std::invalid_argument("The binomial coefficient is only defined here for non-negative n.");
+    }
+    if (k < 0 || k > n)
+    {
+        return bigint();
+    }
+    k = std::min(k, n - k);
+    // The crossover was measured: below it the sieve up to n costs more than the division by k!.
+    if (k == 0 || k <= n / 16 / k)
+    {
+        std::vector<int64_t> numerator_factors;
+        for (int64_t i = 0; i < k; ++i)
+        {
+            numerator_factors.push_back(n - i);
+        }
+        std::vector<bigint> leaves;
+        bigint_pack_factors(numerator_factors, leaves);
+        bigint quotient;
+        bigint remainder;
+        bigint::divide(product(leaves), factorial(k), quotient, remainder);
+        return quotient;
+    }
+    std::vector<int64_t> factors;
+    for (int64_t p : bigint_prime_sieve(n))
+    {
+        int64_t exponent = 0;
+        for (int64_t power = p; power <= n; power = (power > n / p) ? n + 1 : power * p)
+        {
+            exponent += n / power - k / power - (n - k) / power;
+        }
+        for (int64_t i = 0; i < exponent; ++i)
+        {
+            factors.push_back(p);
+        }
+    }
+    std::vector<bigint> leaves;
+    bigint_pack_factors(factors, leaves);
+    return product(leaves);
+}
+
+/**
+ *
+ * @class bigint_view
+ *
+ * @brief `bigint_view` is a non-owning, read-only view of the digits and sign of an integer.
+ *        It is built from a `bigint` without copying, or from any buffer of digits in the same order as `bigint::value`
+ *        (lowest digit first, no leading zeros, 0 being a single 0 digit that is not negative).
+ *        It hashes and compares equal exactly like the `bigint` it describes, so it can be used to look up
+ *        `bigint` keys in hash tables without constructing a key.
+ *
+ */
+class bigint_view
+{
+public:
+    bigint_view(const bigint &num);
+    bigint_view(const int64_t *input_digits, size_t input_size, bool input_is_negative);
+    bool operator==(const bigint_view &rhs) const;
+    bool operator!=(const bigint_view &rhs) const;
+    size_t hash() const;
+
+private:
+    /**
+     *
+     * @brief `digits` points to the digits, stored from the lowest to the highest.
+     *
+     */
+    const int64_t *digits;
+
+    /**
+     *
+     * @brief `size` is the number of digits.
+     *
+     */
+    size_t size;
+
+    /**
+     *
+     * @brief `is_negative` is `true` if the viewed integer is negative.
+     *
+     */
+    bool is_negative;
+};
+
+/**
+ *
+ * @brief A constructor that views the digits and sign of a `bigint` object. The `bigint` must outlive the view.
+ *
+ * @param num The `bigint` being viewed.
+ *
+ */
+bigint_view::bigint_view(const bigint &num) : digits(num.value.data()), size(num.value.size()), is_negative(num.is_negative)
+{
+}
+
+/**
+ *
+ * @brief A constructor that views a buffer of digits, stored from the lowest to the highest without leading zeros.
+ *
+ * @param input_digits The pointer to the digits. The buffer must outlive the view.
+ * @param input_size The number of digits.
+ * @param input_is_negative `true` if the viewed integer is negative.
+ *
+ */
+bigint_view::bigint_view(const int64_t *input_digits, size_t input_size, bool input_is_negative)
+    : digits(input_digits), size(input_size), is_negative(input_is_negative)
+{
+}
+
+/**
+ *
+ * @brief Compares two views for equality, comparing the whole digit buffers at once.
+ *
+ * @param rhs The right-hand side view.
+ *
+ * @return `true` if both views describe the same integer, otherwise `false`.
+ *
+ */
+bool bigint_view::operator==(const bigint_view &rhs) const
+{
+    return is_negative == rhs.is_negative && size == rhs.size && std::memcmp(digits, rhs.digits, size * sizeof(int64_t)) == 0;
+}
+
+/**
+ *
+ * @brief Compares two views for inequality.
+ *
+ * @param rhs The right-hand side view.
+ *
+ * @return `false` if both views describe the same integer, otherwise `true`.
+ *
+ */
+bool bigint_view::operator!=(const bigint_view &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ *
+ * @brief Hashes the viewed integer.
+ *
+ *        Every digit is below 16, so the digits are packed as 4-bit nibbles, 64 digits at a time into four 64-bit
+ *        words: word l holds the digits 4j + l for j = 0, ..., 15, the first one in the highest nibble. With SSE2 the
+ *        four words sit in two vector registers, and each step shifts them left by one nibble and ors in the next four
+ *        digits with a single unaligned load; the 16 steps are split into two independent halves. Without SSE2 the same
+ *        words are built one digit at a time, so the hash does not depend on the instruction set. A missing tail is
+ *        packed as zeros. The words are then mixed into four independent lanes with a multiply and xor-shift per word,
+ *        which keeps several multiplications in flight at once. The lanes, the length and the sign are finally combined
+ *        and avalanched. The result is never 0, so `std::hash<bigint>` can use 0 to mark an empty cache.
+ *
+ * @return The hash value.
+ *
+ */
+size_t bigint_view::hash() const
+{
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    uint64_t lanes[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+    size_t chunk_count = (size + 63) / 64;
+    for (size_t c = 0; c < chunk_count; ++c)
+    {
+        const int64_t *chunk = digits + c * 64;
+        alignas(16) uint64_t words[4] = {0, 0, 0, 0};
+        if (size - c * 64 >= 64)
+        {
+#ifdef __SSE2__
+            const __m128i *source = reinterpret_cast<const __m128i *>(chunk);
+            __m128i high_01 = _mm_setzero_si128();
+            __m128i high_23 = _mm_setzero_si128();
+            __m128i low_01 = _mm_setzero_si128();
+            __m128i low_23 = _mm_setzero_si128();
+            for (int j = 0; j < 8; ++j)
+            {
+                high_01 = _mm_or_si128(_mm_slli_epi64(high_01, 4), _mm_loadu_si128(source + 2 * j));
+                high_23 = _mm_or_si128(_mm_slli_epi64(high_23, 4), _mm_loadu_si128(source + 2 * j + 1));
+                low_01 = _mm_or_si128(_mm_slli_epi64(low_01, 4), _mm_loadu_si128(source + 2 * j + 16));
+                low_23 = _mm_or_si128(_mm_slli_epi64(low_23, 4), _mm_loadu_si128(source + 2 * j + 17));
+            }
+            _mm_store_si128(reinterpret_cast<__m128i *>(words), _mm_or_si128(_mm_slli_epi64(high_01, 32), low_01));
+            _mm_store_si128(reinterpret_cast<__m128i *>(words + 2), _mm_or_si128(_mm_slli_epi64(high_23, 32), low_23));
+#else
+            for (int j = 0; j < 16; ++j)
+            {
+                for (int l = 0; l < 4; ++l)
+                {
+                    words[l] = (words[l] << 4) | static_cast<uint64_t>(chunk[4 * j + l]);
+                }
+            }
+#endif
+        }
+        else
+        {
+            // Digit i goes to nibble 15 - i / 4 of word i % 4, where the full-chunk loop above would have put it.
+            for (size_t i = 0; i < size - c * 64; ++i)
+            {
+                words[i % 4] |= static_cast<uint64_t>(chunk[i]) << (4 * (15 - i / 4));
+            }
+        }
+        // A tail of fewer than four digits leaves some words empty, and they are not mixed.
+        size_t used_words = std::min<size_t>(4, size - c * 64);
+        for (size_t l = 0; l < used_words; ++l)
+        {
+            lanes[l] = (lanes[l] ^ words[l]) * multiplier;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+    uint64_t combined = static_cast<uint64_t>(size) * 2 + (is_negative ? 1 : 0);
+    for (uint64_t lane : lanes)
+    {
+        combined = (combined ^ lane) * multiplier;
+        combined ^= combined >> 32;
+    }
+    combined ^= combined >> 33;
+    combined *= 0xFF51AFD7ED558CCDULL;
+    combined ^= combined >> 33;
+    size_t hash = static_cast<size_t>(combined);
+    return (hash == 0) ? 1 : hash;
+}
+
+/**
+ *
+ * @brief `std::hash<bigint>` makes `bigint` usable as the key of `std::unordered_map` and `std::unordered_set`.
+ *        When `BIGINT_CACHE_HASH` is defined, the hash is computed once per value and kept in the object.
+ *
+ */
+namespace std
+{
+    template <>
+    struct hash<bigint>
+    {
+        size_t operator()(const bigint &num) const
+        {
+#ifdef BIGINT_CACHE_HASH
+            size_t cached = num.hash_cache.hash.load(std::memory_order_relaxed);
+            if (cached == 0)
+            {
+                cached = bigint_view(num).hash();
+                num.hash_cache.hash.store(cached, std::memory_order_relaxed);
+            }
+            return cached;
+#else
+            return bigint_view(num).hash();
+#endif
+        }
+    };
+}
+
+/**
+ *
+ * @brief `bigint_hash` is a transparent hash for `bigint` keys.
+ *        Together with `bigint_equal`, it lets `std::unordered_map<bigint, T, bigint_hash, bigint_equal>` be searched
+ *        with a `bigint_view` (C++20 heterogeneous lookup) without constructing a `bigint` key.
+ *
+ */
+struct bigint_hash
+{
+    using is_transparent = void;
+
+    size_t operator()(const bigint &num) const
+    {
+        return std::hash<bigint>()(num);
+    }
+
+    size_t operator()(const bigint_view &num) const
+    {
+        return num.hash();
+    }
+};
+
+/**
+ *
+ * @brief `bigint_equal` is a transparent equality for `bigint` keys, accepting any mix of `bigint` and `bigint_view`.
+ *
+ */
+struct bigint_equal
+{
+    using is_transparent = void;
+
+    bool operator()(const bigint_view &lhs, const bigint_view &rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+/**
+ *
+ * @brief `bigint_float128` is a 128-bit significand with a binary exponent, whose value is
+ *        (high * 2^64 + low) * 2^exponent. `to_double` uses it to bound a `bigint` without reading all of its digits.
+ *
+ */
+struct bigint_float128
+{
+    uint64_t high;
+    uint64_t low;
+    int64_t exponent;
+};
+
+/**
+ *
+ * @brief Multiplies two 64-bit numbers into a 128-bit product, using 32-bit halves so that no compiler extension is needed.
+ *
+ * @param lhs The left-hand side factor.
+ * @param rhs The right-hand side factor.
+ * @param high Receives the upper 64 bits of the product.
+ * @param low Receives the lower 64 bits of the product.
+ *
+ */
+void bigint_multiply_64(uint64_t lhs, uint64_t rhs, uint64_t &high, uint64_t &low)
+{
+    uint64_t lhs_low = lhs & 0xFFFFFFFFULL;
+    uint64_t lhs_high = lhs >> 32;
+    uint64_t rhs_low = rhs & 0xFFFFFFFFULL;
+    uint64_t rhs_high = rhs >> 32;
+    uint64_t low_low = lhs_low * rhs_low;
+    uint64_t high_low = lhs_high * rhs_low;
+    uint64_t low_high = lhs_low * rhs_high;
+    uint64_t middle = (low_low >> 32) + (high_low & 0xFFFFFFFFULL) + (low_high & 0xFFFFFFFFULL);
+    low = (middle << 32) | (low_low & 0xFFFFFFFFULL);
+    high = lhs_high * rhs_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+}
+
+/**
+ *
+ * @brief Returns 10^s for s = 0, ..., 290, each truncated to a 128-bit significand whose top bit is set.
+ *        Every step multiplies the previous entry by 10 and drops at most one unit of the last place, so entry s
+ *        is below the true power by less than 2 * s + 2 units. The table is built once, on first use.
+ *
+ * @return The table, indexed by s.
+ *
+ */
+const std::vector<bigint_float128> &bigint_powers_of_ten()
+{
+    static const std::vector<bigint_float128> powers = []()
+    {
+        std::vector<bigint_float128> table(291);
+        table[0] = {uint64_t(1) << 63, 0, -127};
+        for (size_t s = 1; s < table.size(); ++s)
+        {
+            uint64_t carry_low = 0;
+            uint64_t low = 0;
+            uint64_t carry_high = 0;
+            uint64_t high = 0;
+            bigint_multiply_64(table[s - 1].low, 10, carry_low, low);
+            bigint_multiply_64(table[s - 1].high, 10, carry_high, high);
+            high += carry_low;
+            carry_high += (high < carry_low) ? 1 : 0;
+            // carry_high is between 4 and 9, so 3 or 4 bits spill over the top.
+            int shift = (carry_high >= 8) ? 4 : 3;
+            table[s].low = (low >> shift) | (high << (64 - shift));
+            table[s].high = (high >> shift) | (carry_high << (64 - shift));
+            table[s].exponent = table[s - 1].exponent + shift;
+        }
+        return table;
+    }();
+    return powers;
+}
+
+/**
+ *
+ * @brief Rounds factor * (high * 2^64 + low) * 2^exponent to the nearest double, with ties going to the even mantissa.
+ *        The factor must be at least 2^59 and the top bit of `high` must be set, so that the product needs
+ *        at least 186 bits and its leading 64 bits fall in one word after a shift of at most 6 bits.
+ *
+ * @param factor The 64-bit factor.
+ * @param high The upper half of the 128-bit significand.
+ * @param low The lower half of the 128-bit significand.
+ * @param exponent The binary exponent of the significand.
+ *
+ * @return The correctly rounded double, infinite if the rounded value reaches 2^1024.
+ *
+ */
+double bigint_round_product(uint64_t factor, uint64_t high, uint64_t low, int64_t exponent)
+{
+    uint64_t word_1 = 0;
+    uint64_t word_0 = 0;
+    uint64_t word_2 = 0;
+    uint64_t middle = 0;
+    bigint_multiply_64(factor, low, word_1, word_0);
+    bigint_multiply_64(factor, high, word_2, middle);
+    word_1 += middle;
+    word_2 += (word_1 < middle) ? 1 : 0;
+    while ((word_2 >> 63) == 0)
+    {
+        word_2 = (word_2 << 1) | (word_1 >> 63);
+        word_1 = (word_1 << 1) | (word_0 >> 63);
+        word_0 <<= 1;
+        --exponent;
+    }
+    uint64_t mantissa = word_2 >> 11;
+    uint64_t rest = word_2 & 0x7FF;
+    bool is_sticky = word_1 != 0 || word_0 != 0;
+    if (rest > 0x400 || (rest == 0x400 && (is_sticky || mantissa % 2 == 1)))
+    {
+        ++mantissa;
+    }
+    return std::ldexp(static_cast<double>(mantissa), static_cast<int>(exponent + 139));
+}
+
+/**
+ *
+ * @brief A constructor that takes a floating-point number and converts it to an arbitrary-precision integer,
+ *        truncating toward zero like `static_cast<int64_t>`. A `long double` is converted from its own significand,
+ *        never rounded to `double` first. The constructor is explicit and only accepts floating-point types, so integer arguments still pick
+ *        the `int64_t` constructor.
+ *
+ * @param input_num The floating-point number.
+ *
+ * @throws std::invalid_argument If the number is NaN or infinite.
+ *
+ */
+template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type>
+bigint::bigint(T input_num)
+{
+    *this = std::is_same<T, long double>::value ? from_long_double(input_num) : from_double(static_cast<double>(input_num));
+}
+
+/**
+ *
+ * @brief Converts a double to a `bigint`, truncating toward zero.
+ *        Values below 2^63 go through `int64_t`. Larger values are exactly mantissa * 2^exponent,
+ *        so the result is built by `from_binary`, with no decimal string in between.
+ *
+ * @param input_num The double.
+ *
+ * @return A new `bigint` holding the truncated value.
+ *
+ * @throws std::invalid_argument If the number is NaN or infinite.
+ *
+ */
+bigint bigint::from_double(double input_num)
+{
+    if (std::isnan(input_num) || std::isinf(input_num))
+    {
+        throw std::invalid_argument("Cannot convert NaN or infinity to bigint.");
+    }
+    double truncated = std::trunc(input_num);
+    if (std::fabs(truncated) < 9223372036854775808.0)
+    {
+        return bigint(static_cast<int64_t>(truncated));
+    }
+    int exponent = 0;
+    double fraction = std::frexp(std::fabs(truncated), &exponent);
+    uint64_t mantissa = static_cast<uint64_t>(std::ldexp(fraction, 53));
+    bigint converted = from_binary(mantissa, exponent - 53);
+    converted.is_negative = truncated < 0;
+    return converted;
+}
+
+/**
+ *
+ * @brief Converts a long double to a `bigint`, truncating toward zero.
+ *        The significand has 64 bits in the x87 format and 113 bits in quadruple precision, more than one
+ *        `uint64_t` can hold in general, so it is taken 32 bits at a time. Each piece is exact and sits at a known
+ *        power of two, so the result is the sum of a few `from_binary` terms.
+ *
+ * @param input_num The long double.
+ *
+ * @return A new `bigint` holding the truncated value.
+ *
+ * @throws std::invalid_argument If the number is NaN or infinite.
+ *
+ */
+bigint bigint::from_long_double(long double input_num)
+{
+    if (std::isnan(input_num) || std::isinf(input_num))
+    {
+        throw std::invalid_argument("Cannot convert NaN or infinity to bigint.");
+    }
+    long double truncated = std::trunc(input_num);
+    if (std::fabs(truncated) < 9223372036854775808.0L)
+    {
+        return bigint(static_cast<int64_t>(truncated));
+    }
+    int exponent = 0;
+    long double fraction = std::frexp(std::fabs(truncated), &exponent);
+    bigint converted;
+    for (int64_t shift = 32; fraction != 0; shift += 32)
+    {
+        fraction = std::ldexp(fraction, 32);
+        long double piece = std::trunc(fraction);
+        fraction -= piece;
+        uint64_t bits = static_cast<uint64_t>(piece);
+        int64_t piece_exponent = exponent - shift;
+        // The value is an integer, so the bits of a piece that fall below 2^0 are all zero.
+        if (piece_exponent < 0)
+        {
+            bits >>= -piece_exponent;
+            piece_exponent = 0;
+        }
+        converted += from_binary(bits, piece_exponent);
+    }
+    converted.is_negative = truncated < 0;
+    return converted;
+}
+
+/**
+ *
+ * @brief Computes mantissa * 2^exponent without a multiplication at full size.
+ *        The number is kept in limbs of 9 decimal digits and doubled 32 times per pass, which keeps every limb
+ *        product below 2^62; the limbs are split into decimal digits only at the end.
+ *
+ * @param mantissa The 64-bit mantissa.
+ * @param exponent The non-negative binary exponent.
+ *
+ * @return A new non-negative `bigint` representing mantissa * 2^exponent.
+ *
+ */
+bigint bigint::from_binary(uint64_t mantissa, int64_t exponent)
+{
+    const uint64_t limb_base = 1000000000;
+    std::vector<uint64_t> limbs;
+    do
+    {
+        limbs.push_back(mantissa % limb_base);
+        mantissa /= limb_base;
+    } while (mantissa > 0);
+    while (exponent > 0)
+    {
+        int64_t shift = std::min<int64_t>(exponent, 32);
+        exponent -= shift;
+        uint64_t carry = 0;
+        for (uint64_t &limb : limbs)
+        {
+            uint64_t current = (limb << shift) + carry;
+            limb = current % limb_base;
+            carry = current / limb_base;
+        }
+        while (carry > 0)
+        {
+            limbs.push_back(carry % limb_base);
+            carry /= limb_base;
+        }
+    }
+
+    bigint converted;
+    converted.value.resize(limbs.size() * 9);
+    for (size_t i = 0; i < limbs.size(); ++i)
+    {
+        for (size_t j = 0; j < 9; ++j)
+        {
+            converted.value[9 * i + j] = static_cast<int64_t>(limbs[i] % 10);
+            limbs[i] /= 10;
+        }
+    }
+    while (converted.value.size() > 1 && converted.value.back() == 0)
+    {
+        converted.value.pop_back();
+    }
+    return converted;
+}
+
+/**
+ *
+ * @brief Checks whether the `bigint` object fits in a signed 64-bit integer.
+ *        Only the digit count and at most 19 digits are read.
+ *
+ * @return `true` if the value is within [INT64_MIN, INT64_MAX], otherwise `false`.
+ *
+ */
+bool bigint::fits_int64() const
+{
+    if (value.size() > 19)
+    {
+        return false;
+    }
+    uint64_t magnitude = magnitude_to_uint64();
+    return is_negative ? magnitude <= 9223372036854775808ULL : magnitude <= 9223372036854775807ULL;
+}
+
+/**
+ *
+ * @brief Converts the `bigint` object to a signed 64-bit integer, reading the digits directly.
+ *
+ * @return The value as `int64_t`.
+ *
+ * @throws std::out_of_range If the value does not fit in `int64_t`.
+ *
+ */
+int64_t bigint::to_int64() const
+{
+    if (!fits_int64())
+    {
+        throw std::out_of_range("The bigint does not fit in int64_t.");
+    }
+    uint64_t magnitude = magnitude_to_uint64();
+    if (is_negative)
+    {
+        // Written so that INT64_MIN never passes through a positive int64_t.
+        return -static_cast<int64_t>(magnitude - 1) - 1;
+    }
+    return static_cast<int64_t>(magnitude);
+}
+
+/**
+ *
+ * @brief Converts the `bigint` object to the nearest double, with ties going to the even mantissa.
+ *
+ *        Up to 19 digits the magnitude fits in `uint64_t`, whose conversion to double is already correctly rounded.
+ *        Above 309 digits the value exceeds every finite double, so the result is infinite without reading the digits.
+ *        In between, the leading 19 digits L and the count s of the other digits bound the value between L * 10^s and
+ *        (L + 1) * 10^s. Both bounds are rounded with a 128-bit power of ten from `bigint_powers_of_ten`, widened by
+ *        its truncation error, and when they round to the same double that double is the answer. The bounds are less
+ *        than a hundredth of a unit in the last place apart, so this settles almost every value.
+ *
+ *        Only a value within that distance of a midpoint between two doubles is checked exactly: with the estimate equal
+ *        to mantissa * 2^k, the midpoints to its two neighbours are (2 * mantissa +- 1) * 2^(k - 1), built by
+ *        `from_binary`, and the estimate moves one step until the value lies between them.
+ *
+ * @return The correctly rounded double, possibly infinite.
+ *
+ */
+double bigint::to_double() const
+{
+    if (value.size() <= 19)
+    {
+        double magnitude = static_cast<double>(magnitude_to_uint64());
+        return is_negative ? -magnitude : magnitude;
+    }
+    double magnitude = std::numeric_limits<double>::infinity();
+    if (value.size() <= 309)
+    {
+        uint64_t leading = 0;
+        for (size_t i = value.size(); i > value.size() - 19; --i)
+        {
+            leading = leading * 10 + static_cast<uint64_t>(value[i - 1]);
+        }
+        size_t scale = value.size() - 19;
+        const bigint_float128 &power_of_ten = bigint_powers_of_ten()[scale];
+        uint64_t error = 2 * static_cast<uint64_t>(scale) + 2;
+        magnitude = bigint_round_product(leading, power_of_ten.high, power_of_ten.low, power_of_ten.exponent);
+        bool is_settled = false;
+        if (power_of_ten.low + error >= power_of_ten.low || power_of_ten.high != std::numeric_limits<uint64_t>::max())
+        {
+            uint64_t upper_low = power_of_ten.low + error;
+            uint64_t upper_high = power_of_ten.high + ((upper_low < error) ? 1 : 0);
+            is_settled = magnitude == bigint_round_product(leading + 1, upper_high, upper_low, power_of_ten.exponent);
+        }
+
+        // Twice the value is compared with the sum of two neighbouring doubles, so the midpoints stay integers.
+        bigint twice;
+        if (!is_settled)
+        {
+            twice = is_negative ? -(*this) : *this;
+            twice += twice;
+        }
+        while (!is_settled)
+        {
+            int exponent = 0;
+            double fraction = std::frexp(magnitude, &exponent);
+            uint64_t mantissa = static_cast<uint64_t>(std::ldexp(fraction, 53));
+            bigint upper = from_binary(4 * mantissa + 2, exponent - 54);
+            // Just above a power of two, the gap to the lower neighbour is half as wide.
+            bigint lower = from_binary((mantissa == (uint64_t(1) << 52)) ? (uint64_t(1) << 54) - 1 : 4 * mantissa - 2, exponent - 54);
+            if (twice > upper || (twice == upper && mantissa % 2 == 1))
+            {
+                magnitude = std::nextafter(magnitude, std::numeric_limits<double>::infinity());
+                is_settled = twice == upper || std::isinf(magnitude);
+            }
+            else if (twice < lower || (twice == lower && mantissa % 2 == 1))
+            {
+                magnitude = std::nextafter(magnitude, 0.0);
+                is_settled = twice == lower;
+            }
+            else
+            {
+                is_settled = true;
+            }
+        }
+    }
+    return is_negative ? -magnitude : magnitude;
+}
+
+#endif
\ No newline at end of file
@@ -1,7 +1,224 @@
 #include "bigint.hpp"
+#include "bigdecimal.hpp"
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ *
+ * @brief Converts a signed 128-bit integer to its decimal string.
+ *        The standard library cannot print `__int128`, and it is the reference type of the differential test.
+ *
+ * @param num The signed 128-bit integer.
+ *
+ * @return The decimal string of `num`.
+ *
+ */
+std::string int128_to_string(__int128 num)
+{
+    if (num == 0)
+    {
+        return "0";
+    }
+    bool is_negative = num < 0;
+    std::string digits;
+    while (num != 0)
+    {
+        int digit = static_cast<int>(num % 10);
+        digits.push_back(static_cast<char>('0' + (is_negative ? -digit : digit)));
+        num /= 10;
+    }
+    if (is_negative)
+    {
+        digits.push_back('-');
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+/**
+ *
+ * @brief Converts a `bigint` to its decimal string through `operator<<`.
+ *
+ * @param num The `bigint` object.
+ *
+ * @return The decimal string of `num`.
+ *
+ */
+std::string bigint_to_string(const bigint &num)
+{
+    std::ostringstream os;
+    os << num;
+    return os.str();
+}
+
+/**
+ *
+ * @brief Compares `bigint` against `__int128` on random operands of random length and sign.
+ *        Operands stay within 18 digits, so every sum, difference and product is exact in the reference type.
+ *
+ * @param rounds The number of random operand pairs.
+ * @param seed The seed of the random generator, printed on failure so a case can be replayed.
+ *
+ * @return The number of operand pairs on which every operation agreed with the reference.
+ *
+ */
+int differential_test(int rounds, uint32_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> length(1, 18);
+    int matched = 0;
+    for (int round = 0; round < rounds; ++round)
+    {
+        int64_t operands[2];
+        for (int64_t &operand : operands)
+        {
+            int64_t limit = 1;
+            for (int i = length(generator); i > 0; --i)
+            {
+                limit *= 10;
+            }
+            operand = static_cast<int64_t>(generator() % static_cast<uint64_t>(limit));
+            if (generator() % 2 == 1)
+            {
+                operand = -operand;
+            }
+        }
+        __int128 l = operands[0];
+        __int128 r = operands[1];
+        bigint lhs(operands[0]);
+        bigint rhs(int128_to_string(r));
+        bigint compound = lhs;
+        compound += rhs;
+        compound *= rhs;
+        compound -= lhs;
+
+        bool is_match = bigint_to_string(lhs + rhs) == int128_to_string(l + r) &&
+                        bigint_to_string(lhs - rhs) == int128_to_string(l - r) &&
+                        bigint_to_string(lhs * rhs) == int128_to_string(l * r) &&
+                        bigint_to_string(-lhs) == int128_to_string(-l) &&
+                        bigint_to_string(compound) == int128_to_string((l + r) * r - l) &&
+                        (lhs == rhs) == (l == r) &&
+                        (lhs != rhs) == (l != r) &&
+                        (lhs < rhs) == (l < r) &&
+                        (lhs > rhs) == (l > r) &&
+                        (lhs <= rhs) == (l <= r) &&
+                        (lhs >= rhs) == (l >= r);
+        if (is_match)
+        {
+            ++matched;
+        }
+        else
+        {
+            std::cout << "mismatch with seed " << seed << " in round " << round << ": lhs = " << int128_to_string(l) << ", rhs = " << int128_to_string(r) << "\n";
+        }
+    }
+    return matched;
+}
+
+/**
+ *
+ * @brief Multiplies two non-negative decimal strings digit by digit.
+ *        It works on strings rather than on `bigint`, so it stays an independent reference when `operator*` switches to faster kernels.
+ *
+ * @param lhs The digits of the left-hand side, most significant first.
+ * @param rhs The digits of the right-hand side, most significant first.
+ *
+ * @return The digits of the product, most significant first.
+ *
+ */
+std::string reference_multiply(const std::string &lhs, const std::string &rhs)
+{
+    std::vector<int64_t> digits(lhs.size() + rhs.size(), 0);
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        for (size_t j = 0; j < rhs.size(); ++j)
+        {
+            digits[i + j + 1] += (lhs[i] - '0') * (rhs[j] - '0');
+        }
+    }
+    for (size_t i = digits.size() - 1; i > 0; --i)
+    {
+        digits[i - 1] += digits[i] / 10;
+        digits[i] %= 10;
+    }
+    std::string product;
+    for (int64_t digit : digits)
+    {
+        if (!product.empty() || digit != 0)
+        {
+            product.push_back(static_cast<char>('0' + digit));
+        }
+    }
+    return product.empty() ? "0" : product;
+}
+
+/**
+ *
+ * @brief Checks `bigint` on operands of up to 2000 digits, far beyond the reach of `__int128`.
+ *        Products are compared with `reference_multiply`, and sums and products are cross-checked
+ *        through the identities (a + b)^2 = a^2 + 2ab + b^2 and (a + b)(a - b) = a^2 - b^2.
+ *
+ * @param rounds The number of random operand pairs.
+ * @param seed The seed of the random generator, printed on failure so a case can be replayed.
+ *
+ * @return The number of operand pairs on which every check passed.
+ *
+ */
+int large_operand_test(int rounds, uint32_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> length(1, 2000);
+    std::uniform_int_distribution<int> digit(0, 9);
+    int matched = 0;
+    for (int round = 0; round < rounds; ++round)
+    {
+        std::string magnitudes[2];
+        for (std::string &magnitude : magnitudes)
+        {
+            magnitude.resize(static_cast<size_t>(length(generator)));
+            for (char &c : magnitude)
+            {
+                c = static_cast<char>('0' + digit(generator));
+            }
+            magnitude[0] = static_cast<char>('1' + digit(generator) % 9);
+        }
+        bool is_negative_l = generator() % 2 == 1;
+        bool is_negative_r = generator() % 2 == 1;
+        bigint lhs((is_negative_l ? "-" : "") + magnitudes[0]);
+        bigint rhs((is_negative_r ? "-" : "") + magnitudes[1]);
+        bigint two(2);
+
+        bigint lhs_squared = lhs * lhs;
+        bigint rhs_squared = rhs * rhs;
+        bigint sum = lhs + rhs;
+        std::string expected_product = reference_multiply(magnitudes[0], magnitudes[1]);
+        if (is_negative_l != is_negative_r)
+        {
+            expected_product = "-" + expected_product;
+        }
+
+        bool is_match = bigint_to_string(lhs * rhs) == expected_product &&
+                        bigint_to_string(lhs_squared) == reference_multiply(magnitudes[0], magnitudes[0]) &&
+                        sum * sum == lhs_squared + two * lhs * rhs + rhs_squared &&
+                        sum * (lhs - rhs) == lhs_squared - rhs_squared;
+        if (is_match)
+        {
+            ++matched;
+        }
+        else
+        {
+            std::cout << "mismatch with seed " << seed << " in round " << round << ": lhs has " << magnitudes[0].size() << " digits, rhs has " << magnitudes[1].size() << " digits" << "\n";
+        }
+    }
+    return matched;
+}
 
 int main()
 {
+    int failures = 0;
     try
     {
         // Test the Default Constructor
@@ -173,9 +390,187 @@ int main()
         std::cout << "Now a = 11 and b = -9," << "\n";
         std::cout << "if c = --a, then c = " << h_1 << " (should be 10 if correct), a = " << a << " (should be 10 if correct)" << "\n";
         std::cout << "if c = --b, then c = " << h_2 << " (should be -10 if correct), b = " << b << " (should be -10 if correct)" << "\n";
+
+        // Test against a reference implementation on random operands
+        std::cout << "\n"
+                  << "Test Randomized Differential Against __int128" << "\n";
+        int differential_matched = differential_test(10000, 20241019);
+        failures += 10000 - differential_matched;
+        std::cout << differential_matched << " of 10000 random cases matched (should be 10000 if correct)" << "\n";
+        int large_matched = large_operand_test(30, 20241020);
+        failures += 30 - large_matched;
+        std::cout << large_matched << " of 30 random cases with up to 2000 digits matched (should be 30 if correct)" << "\n";
+
+        // Test Integer Roots and Perfect Powers
+        std::cout << "\n"
+                  << "Test Integer Roots and Perfect Powers" << "\n";
+        bigint square(std::string("152415787532388367501905199875019052100"));
+        std::cout << "isqrt(152415787532388367501905199875019052100) = " << isqrt(square) << " (should be 12345678901234567890 if correct)" << "\n";
+        std::cout << "isqrt(152415787532388367501905199875019052099) = " << isqrt(--square) << " (should be 12345678901234567889 if correct)" << "\n";
+        std::cout << "iroot(1000000000000000000000000000000, 3) = " << iroot(bigint(std::string("1000000000000000000000000000000")), 3) << " (should be 10000000000 if correct)" << "\n";
+        std::cout << "iroot(-30, 3) = " << iroot(bigint(int64_t(-30)), 3) << " (should be -3 if correct)" << "\n";
+        std::cout << "is_perfect_square(152415787532388367501905199875019052099) ? The answer is " << is_perfect_square(square) << " (should be false if correct)" << "\n";
+        std::cout << "is_perfect_square(152415787532388367501905199875019052100) ? The answer is " << is_perfect_square(++square) << " (should be true if correct)" << "\n";
+        std::cout << "is_perfect_power(-243) ? The answer is " << is_perfect_power(bigint(int64_t(-243))) << " (should be true if correct)" << "\n";
+        std::cout << "is_perfect_power(1000000000000000000000000000001) ? The answer is " << is_perfect_power(bigint(std::string("1000000000000000000000000000001"))) << " (should be false if correct)" << "\n";
+        bigint power_of_seven(int64_t(1));
+        for (int i = 0; i < 1009; ++i)
+        {
+            power_of_seven *= bigint(int64_t(7));
+        }
+        std::cout << "is_perfect_power(7^1009) ? The answer is " << is_perfect_power(power_of_seven) << " (should be true if correct)" << "\n";
+        std::cout << "is_perfect_power(7^1009 + 1) ? The answer is " << is_perfect_power(power_of_seven + bigint(int64_t(1))) << " (should be false if correct)" << "\n";
+
+        // Test Primality and Modular Inverse
+        std::cout << "\n"
+                  << "Test Primality and Modular Inverse" << "\n";
+        std::cout << "is_probable_prime(997) ? The answer is " << is_probable_prime(bigint(int64_t(997))) << " (should be true if correct)" << "\n";
+        std::cout << "is_probable_prime(561) ? The answer is " << is_probable_prime(bigint(int64_t(561))) << " (should be false if correct)" << "\n";
+        std::cout << "is_probable_prime(2^127 - 1) ? The answer is " << is_probable_prime(bigint(std::string("170141183460469231731687303715884105727"))) << " (should be true if correct)" << "\n";
+        std::cout << "is_probable_prime(3825123056546413051) ? The answer is " << is_probable_prime(bigint(std::string("3825123056546413051")), 0) << " (should be false if correct)" << "\n";
+        std::cout << "modinv(3, 11) = " << modinv(bigint(int64_t(3)), bigint(int64_t(11))) << " (should be 4 if correct)" << "\n";
+        std::cout << "modinv(-98765432109876543210, 2^127 - 1) = " << modinv(bigint(std::string("-98765432109876543210")), bigint(std::string("170141183460469231731687303715884105727"))) << " (should be 164975635390049177954920943729338366062 if correct)" << "\n";
+        try
+        {
+            modinv(bigint(int64_t(6)), bigint(int64_t(9)));
+        }
+        catch (const std::invalid_argument &e)
+        {
+            std::cout << "modinv(6, 9): " << e.what() << "\n";
+        }
+        bigint_montgomery context(bigint(int64_t(7)));
+        std::cout << "Montgomery 3 * 5 mod 7 = " << context.from_montgomery(context.multiply(context.to_montgomery(bigint(int64_t(3))), context.to_montgomery(bigint(int64_t(5))))) << " (should be 1 if correct)" << "\n";
+        try
+        {
+            context.multiply(bigint(std::string("123456789")), context.one());
+        }
+        catch (const std::invalid_argument &e)
+        {
+            std::cout << "Montgomery multiply by 123456789 modulo 7: " << e.what() << "\n";
+        }
+
+        // Test Factorial, Binomial and Product
+        std::cout << "\n"
+                  << "Test Factorial, Binomial and Product" << "\n";
+        std::cout << "factorial(0) = " << factorial(0) << " (should be 1 if correct)" << "\n";
+        std::cout << "factorial(25) = " << factorial(25) << " (should be 15511210043330985984000000 if correct)" << "\n";
+        bigint slow_factorial(int64_t(1));
+        for (int64_t i = 2; i <= 1000; ++i)
+        {
+            slow_factorial *= bigint(i);
+        }
+        std::cout << "(factorial(1000) == 1 * 2 * ... * 1000) ? The answer is " << (factorial(1000) == slow_factorial) << " (should be true if correct)" << "\n";
+        std::cout << "binomial(100, 50) = " << binomial(100, 50) << " (should be 100891344545564193334812497256 if correct)" << "\n";
+        std::cout << "binomial(10, 11) = " << binomial(10, 11) << " (should be 0 if correct)" << "\n";
+        std::cout << "binomial(1000000000, 999999995) = " << binomial(1000000000, 999999995) << " (should be 8333333250000000291666666250000000200000000 if correct)" << "\n";
+        std::vector<int64_t> factors = {-3, 7, 11, 13};
+        std::cout << "product({-3, 7, 11, 13}) = " << product(factors.begin(), factors.end()) << " (should be -3003 if correct)" << "\n";
+
+        // Test Hashing
+        std::cout << "\n"
+                  << "Test Hashing" << "\n";
+        std::unordered_set<bigint> keys;
+        for (int64_t i = -500; i <= 500; ++i)
+        {
+            keys.insert(bigint(i) * bigint(std::string("1000000000000000000000")));
+        }
+        keys.insert(bigint(std::string("-0")));
+        std::cout << "distinct keys: " << keys.size() << " (should be 1001 if correct)" << "\n";
+        std::cout << "(hash(-86360279) == hash(-86360279)) ? The answer is " << (std::hash<bigint>()(-num_1) == std::hash<bigint>()(bigint(std::string("-86360279")))) << " (should be true if correct)" << "\n";
+        std::cout << "(hash(86360279) == hash(-86360279)) ? The answer is " << (std::hash<bigint>()(num_1) == std::hash<bigint>()(-num_1)) << " (should be false if correct)" << "\n";
+        std::unordered_map<bigint, int, bigint_hash, bigint_equal> counts;
+        counts[num_1] = 7;
+        int64_t digits[] = {9, 7, 2, 0, 6, 3, 6, 8};
+        bigint_view view(digits, 8, false);
+        std::cout << "(bigint_view of 86360279 == 86360279) ? The answer is " << bigint_equal()(view, num_1) << " (should be true if correct)" << "\n";
+        std::cout << "(hash of the view == hash of the bigint) ? The answer is " << (bigint_hash()(view) == bigint_hash()(num_1)) << " (should be true if correct)" << "\n";
+#ifdef __cpp_lib_generic_unordered_lookup
+        std::cout << "lookup by bigint_view: " << counts.find(view)->second << " (should be 7 if correct)" << "\n";
+#endif
+
+        // Test Decimal Fixed-Point Numbers
+        std::cout << "\n"
+                  << "Test Decimal Fixed-Point Numbers" << "\n";
+        bigdecimal price(std::string("-123.4500"));
+        bigdecimal rate(std::string("0.05"));
+        std::cout << "-123.4500 + 0.05 = " << price + rate << " (should be -123.4000 if correct)" << "\n";
+        std::cout << "-123.4500 - 0.05 = " << price - rate << " (should be -123.5000 if correct)" << "\n";
+        std::cout << "-123.4500 * 0.05 = " << price * rate << " (should be -6.172500 if correct)" << "\n";
+        std::cout << "(-123.4500 * 0.05).rescale(2) = " << (price * rate).rescale(2) << " (should be -6.17 if correct)" << "\n";
+        std::cout << "7 / 3 with scale 5 = " << bigdecimal(std::string("7")).divide(bigdecimal(std::string("3")), 5) << " (should be 2.33333 if correct)" << "\n";
+        std::cout << "-7 / 3 with scale 0, rounding to floor = " << bigdecimal(std::string("-7")).divide(bigdecimal(std::string("3")), 0, BIGDECIMAL_ROUND_FLOOR) << " (should be -3 if correct)" << "\n";
+        std::cout << "2.5 rounded half even = " << bigdecimal(std::string("2.5")).rescale(0) << ", 3.5 rounded half even = " << bigdecimal(std::string("3.5")).rescale(0) << " (should be 2 and 4 if correct)" << "\n";
+        std::cout << "-2.5 rounded half up = " << bigdecimal(std::string("-2.5")).rescale(0, BIGDECIMAL_ROUND_HALF_UP) << " (should be -3 if correct)" << "\n";
+        std::cout << "0.001 with scale 5 = " << bigdecimal(std::string("0.001")).rescale(5) << " (should be 0.00100 if correct)" << "\n";
+        std::cout << "(1.5 == 1.50) ? The answer is " << (bigdecimal(std::string("1.5")) == bigdecimal(std::string("1.50"))) << " (should be true if correct)" << "\n";
+
+        // Test Conversions to and from double and int64_t
+        std::cout << "\n"
+                  << "Test Conversions" << "\n";
+        std::cout << "bigint(INT64_MIN) = " << bigint(INT64_MIN) << " (should be -9223372036854775808 if correct)" << "\n";
+        std::cout << "bigint(-2.9) = " << bigint(-2.9) << " (should be -2 if correct)" << "\n";
+        std::cout << "bigint(1e20) = " << bigint(1e20) << " (should be 100000000000000000000 if correct)" << "\n";
+        // 2^64 + 2 needs 64 significant bits, so it only survives when long double is wider than double.
+        std::cout << "bigint(18446744073709551618.0L) = " << bigint(18446744073709551618.0L) << " (should be " << ((std::numeric_limits<long double>::digits >= 64) ? "18446744073709551618" : "18446744073709551616") << " if correct)" << "\n";
+        if (std::numeric_limits<long double>::max_exponent > 16000)
+        {
+            bigint expected_power(int64_t(16));
+            for (int i = 0; i < 258; ++i)
+            {
+                expected_power *= bigint(int64_t(1) << 62);
+            }
+            std::cout << "(bigint(2^16000 as long double) == 2^16000) ? The answer is " << (bigint(std::ldexp(1.0L, 16000)) == expected_power) << " (should be true if correct)" << "\n";
+        }
+        std::cout << "-9223372036854775808 to_int64 = " << bigint(std::string("-9223372036854775808")).to_int64() << " (should be -9223372036854775808 if correct)" << "\n";
+        std::cout << "(9223372036854775808 fits int64) ? The answer is " << bigint(std::string("9223372036854775808")).fits_int64() << " (should be false if correct)" << "\n";
+        try
+        {
+            bigint(std::string("9223372036854775808")).to_int64();
+        }
+        catch (const std::out_of_range &e)
+        {
+            std::cout << "9223372036854775808 to_int64: " << e.what() << "\n";
+        }
+        std::cout << std::fixed << std::setprecision(0);
+        std::cout << "9007199254740993 to_double = " << bigint(std::string("9007199254740993")).to_double() << " (should be 9007199254740992 if correct)" << "\n";
+        std::cout << "2^64 + 2^11 to_double = " << bigint(std::string("18446744073709553664")).to_double() << " (should be 18446744073709551616 if correct)" << "\n";
+        std::cout << "2^64 + 2^11 + 1 to_double = " << bigint(std::string("18446744073709553665")).to_double() << " (should be 18446744073709555712 if correct)" << "\n";
+        std::cout << "2^64 + 3 * 2^11 to_double = " << bigint(std::string("18446744073709557760")).to_double() << " (should be 18446744073709559808 if correct)" << "\n";
+        std::cout << "-10^400 to_double = " << bigint(std::string("-1" + std::string(400, '0'))).to_double() << " (should be -inf if correct)" << "\n";
+        std::cout << "(bigint(DBL_MAX).to_double() == DBL_MAX) ? The answer is " << (bigint(std::numeric_limits<double>::max()).to_double() == std::numeric_limits<double>::max()) << " (should be true if correct)" << "\n";
+
+#ifdef BIGINT_INSTRUMENTATION
+        // Test the Instrumentation Counters
+        std::cout << "\n"
+                  << "Test Instrumentation Counters" << "\n";
+        bigint_stats_reset();
+        bigint product = bigint(std::string("123")) * bigint(std::string("4567"));
+        bigint_stats stats = bigint_stats_snapshot();
+        std::cout << "123 * 4567 = " << product << " (should be 561741 if correct)" << "\n";
+        std::cout << "multiplication calls: " << stats.ops[BIGINT_OP_MULTIPLY_SCHOOLBOOK].calls << " (should be 1 if correct)" << "\n";
+        std::cout << "multiplication digits read: " << stats.ops[BIGINT_OP_MULTIPLY_SCHOOLBOOK].limbs << " (should be 7 if correct)" << "\n";
+        std::cout << "constructor calls (two operands and the product): " << stats.ops[BIGINT_OP_CONSTRUCT].calls << " (should be 3 if correct)" << "\n";
+        bigint_stats_reset();
+        bigint mixed_sum = bigint(5) + bigint(-3);
+        stats = bigint_stats_snapshot();
+        std::cout << "5 + -3 = " << mixed_sum << " (should be 2 if correct)" << "\n";
+        std::cout << "addition calls: " << stats.ops[BIGINT_OP_ADD].calls << " (should be 1 if correct)" << "\n";
+        std::cout << "subtraction calls: " << stats.ops[BIGINT_OP_SUBTRACT].calls << " (should be 1 if correct)" << "\n";
+        bigint_stats_reset();
+        bigint mixed_difference = bigint(5) - bigint(-3);
+        stats = bigint_stats_snapshot();
+        std::cout << "5 - -3 = " << mixed_difference << " (should be 8 if correct)" << "\n";
+        std::cout << "addition calls: " << stats.ops[BIGINT_OP_ADD].calls << " (should be 1 if correct)" << "\n";
+        std::cout << "subtraction calls: " << stats.ops[BIGINT_OP_SUBTRACT].calls << " (should be 1 if correct)" << "\n";
+        bigint_stats_reset();
+        std::cout << "multiplication calls after reset: " << bigint_stats_snapshot().ops[BIGINT_OP_MULTIPLY_SCHOOLBOOK].calls << " (should be 0 if correct)" << "\n";
+#endif
     }
     catch (const std::exception &e)
     {
         std::cout << "An exception is threw:" << e.what() << "\n";
+        return 1;
     }
+    // Only the randomized checks decide the exit status; the printed checks above are compared by eye.
+    return failures == 0 ? 0 : 1;
 }
\ No newline at end of file